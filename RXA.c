@@ -94,6 +94,7 @@ void create_rxa (int channel)
 		ch[channel].dsp_size,							// buffer size
 		max(2048, ch[channel].dsp_size),				// number of coefficients
 		0,												// minimum phase flag
+		0,												// uniform partitions
 		rxa[channel].midbuff,							// pointer to input buffer
 		rxa[channel].midbuff,							// pointer to output buffer
 		-4150.0,										// lower filter frequency
@@ -403,6 +404,9 @@ void create_rxa (int channel)
 		1,												// wintype
 		1.0);											// gain
 
+	// EQ and bp1 as one convolution when nothing runs between them
+	rxa[channel].eqbp1.p = create_fcfuse (rxa[channel].eqp.p->p, rxa[channel].bp1.p->p);
+
 	// pull phase & scope display data
 	rxa[channel].sip1.p = create_siphon (
 		1,												// run - needed only for phase display
@@ -513,6 +517,7 @@ void destroy_rxa (int channel)
 	destroy_speak (rxa[channel].speak.p);
 	destroy_cbl (rxa[channel].cbl.p);
 	destroy_siphon (rxa[channel].sip1.p);
+	destroy_fcfuse (rxa[channel].eqbp1.p);
 	destroy_bandpass (rxa[channel].bp1.p);
 	destroy_meter (rxa[channel].agcmeter.p);
 	destroy_wcpagc (rxa[channel].agc.p);
@@ -568,6 +573,7 @@ void flush_rxa (int channel)
 	flush_wcpagc (rxa[channel].agc.p);
 	flush_meter (rxa[channel].agcmeter.p);
 	flush_bandpass (rxa[channel].bp1.p);
+	flush_fcfuse (rxa[channel].eqbp1.p);
 	flush_siphon (rxa[channel].sip1.p);
 	flush_cbl (rxa[channel].cbl.p);
 	flush_speak (rxa[channel].speak.p);
@@ -577,51 +583,100 @@ void flush_rxa (int channel)
 	flush_resample (rxa[channel].rsmpout.p);
 }
 
+void setBuffers_rxa (int channel, double* in, double* out)
+{
+	// binds the ends of the pipeline to the iobuff slots dexchange() handed out for the next xrxa()
+	setBuffers_shift (rxa[channel].shift.p, in, in);
+	setBuffers_resample (rxa[channel].rsmpin.p, in, rxa[channel].midbuff);
+	setBuffers_resample (rxa[channel].rsmpout.p, rxa[channel].midbuff, out);
+}
+
 void xrxa (int channel)
 {
+	PROF_BEGIN (channel);
 	xshift (rxa[channel].shift.p);
+	PROF_MARK (channel, "shift");
 	xresample (rxa[channel].rsmpin.p);
+	PROF_MARK (channel, "rsmpin");
 	xgen (rxa[channel].gen0.p);
+	PROF_MARK (channel, "gen0");
 	xmeter (rxa[channel].adcmeter.p);
+	PROF_MARK (channel, "adcmeter");
 	xbpsnbain (rxa[channel].bpsnba.p, 0);
+	PROF_MARK (channel, "bpsnbain.0");
 	xnbp (rxa[channel].nbp0.p, 0);
+	PROF_MARK (channel, "nbp0.0");
 	xmeter (rxa[channel].smeter.p);
+	PROF_MARK (channel, "smeter");
 	xsender (rxa[channel].sender.p);
+	PROF_MARK (channel, "sender");
 	xamsqcap (rxa[channel].amsq.p);
+	PROF_MARK (channel, "amsqcap");
 	xbpsnbaout (rxa[channel].bpsnba.p, 0);
+	PROF_MARK (channel, "bpsnbaout.0");
 	xamd (rxa[channel].amd.p);
+	PROF_MARK (channel, "amd");
 	xfmd (rxa[channel].fmd.p);
+	PROF_MARK (channel, "fmd");
 	xfmsq (rxa[channel].fmsq.p);
+	PROF_MARK (channel, "fmsq");
 	xbpsnbain (rxa[channel].bpsnba.p, 1);
+	PROF_MARK (channel, "bpsnbain.1");
 	xbpsnbaout (rxa[channel].bpsnba.p, 1);
+	PROF_MARK (channel, "bpsnbaout.1");
 	xsnba (rxa[channel].snba.p);
+	PROF_MARK (channel, "snba");
 	xeqp (rxa[channel].eqp.p);
+	PROF_MARK (channel, "eqp");
 	xanf (rxa[channel].anf.p, 0);
+	PROF_MARK (channel, "anf.0");
 	xanr (rxa[channel].anr.p, 0);
+	PROF_MARK (channel, "anr.0");
 	xemnr (rxa[channel].emnr.p, 0);
+	PROF_MARK (channel, "emnr.0");
 #ifdef NEW_NR_ALGORITHMS
         xrnnr (rxa[channel].rnnr.p, 0);
+        PROF_MARK (channel, "rnnr.0");
         xsbnr (rxa[channel].sbnr.p, 0);
+        PROF_MARK (channel, "sbnr.0");
 #endif
 	xbandpass (rxa[channel].bp1.p, 0);
+	PROF_MARK (channel, "bp1.0");
 	xwcpagc (rxa[channel].agc.p);
+	PROF_MARK (channel, "agc");
 	xanf (rxa[channel].anf.p, 1);
+	PROF_MARK (channel, "anf.1");
 	xanr (rxa[channel].anr.p, 1);
+	PROF_MARK (channel, "anr.1");
 	xemnr (rxa[channel].emnr.p, 1);
+	PROF_MARK (channel, "emnr.1");
 #ifdef NEW_NR_ALGORITHMS
         xrnnr (rxa[channel].rnnr.p, 1);
+        PROF_MARK (channel, "rnnr.1");
         xsbnr (rxa[channel].sbnr.p, 1);
+        PROF_MARK (channel, "sbnr.1");
 #endif
 	xbandpass (rxa[channel].bp1.p, 1);
+	PROF_MARK (channel, "bp1.1");
 	xmeter (rxa[channel].agcmeter.p);
+	PROF_MARK (channel, "agcmeter");
 	xsiphon (rxa[channel].sip1.p, 0);
+	PROF_MARK (channel, "sip1.0");
 	xcbl (rxa[channel].cbl.p);
+	PROF_MARK (channel, "cbl");
 	xspeak (rxa[channel].speak.p);
+	PROF_MARK (channel, "speak");
 	xmpeak (rxa[channel].mpeak.p);
+	PROF_MARK (channel, "mpeak");
 	xssql (rxa[channel].ssql.p);
+	PROF_MARK (channel, "ssql");
 	xpanel (rxa[channel].panel.p);
+	PROF_MARK (channel, "panel");
 	xamsq (rxa[channel].amsq.p);
+	PROF_MARK (channel, "amsq");
 	xresample (rxa[channel].rsmpout.p);
+	PROF_MARK (channel, "rsmpout");
+	PROF_END (channel);
 }
 
 void setInputSamplerate_rxa (int channel)
@@ -868,6 +923,23 @@ void RXAbp1Set (int channel)
 	else						a->run = 0;
 	if (!old && a->run) flush_bandpass (a);
 	setUpdate_fircore (a->p);
+	RXAeqbp1Set (channel);
+}
+
+void RXAeqbp1Set (int channel)
+{
+	// Fuse eqp and bp1 when bp1 runs directly after eqp.  ANF, ANR, and EMNR share bp1's position and
+	// are the only stages between them.  Call with the DSP thread excluded.
+	BANDPASS a = rxa[channel].bp1.p;
+	int run = rxa[channel].eqp.p->run && a->run && a->position == 0 &&
+		!(rxa[channel].anf.p->run  && rxa[channel].anf.p->position  == 0) &&
+		!(rxa[channel].anr.p->run  && rxa[channel].anr.p->position  == 0) &&
+#ifdef NEW_NR_ALGORITHMS
+		!(rxa[channel].rnnr.p->run && rxa[channel].rnnr.p->position == 0) &&
+		!(rxa[channel].sbnr.p->run && rxa[channel].sbnr.p->position == 0) &&
+#endif
+		!(rxa[channel].emnr.p->run && rxa[channel].emnr.p->position == 0);
+	setRun_fcfuse (rxa[channel].eqbp1.p, run);
 }
 
 void RXAbpsnbaCheck (int channel, int mode, int notch_run)
@@ -999,3 +1071,14 @@ void RXASetMP (int channel, int mp)
 	SetRXAFMMPde				(channel, mp);
 	SetRXAFMMPaud				(channel, mp);
 }
+
+PORT
+void RXASetNUP (int channel, int nup)
+{
+	int oldstate = SetChannelState (channel, 0, 1);
+	RXANBPSetNUP				(channel, nup);
+	RXABPSNBASetNUP				(channel, nup);
+	SetRXABandpassNUP			(channel, nup);
+	SetRXAEQNUP					(channel, nup);
+	SetChannelState (channel, oldstate, 0);
+}
@@ -125,6 +125,10 @@ struct _rxa
 		EQP p;
 	} eqp;
 	struct
+	{
+		FCFUSE p;
+	} eqbp1;
+	struct
 	{
 		ANF p;
 	} anf;
@@ -182,6 +186,8 @@ extern void destroy_rxa (int channel);
 
 extern void flush_rxa (int channel);
 
+extern void setBuffers_rxa (int channel, double* in, double* out);
+
 extern void xrxa (int channel);
 
 extern void setInputSamplerate_rxa (int channel);
@@ -202,6 +208,8 @@ extern void RXAbp1Check (int channel, int amd_run, int snba_run, int emnr_run, i
 
 extern void RXAbp1Set (int channel);
 
+extern void RXAeqbp1Set (int channel);
+
 extern void RXAbpsnbaCheck (int channel, int mode, int notch_run);
 
 extern void RXAbpsnbaSet (int channel);
@@ -554,41 +554,83 @@ void flush_txa (int channel)
 	flush_meter (txa[channel].outmeter.p);
 }
 
+void setBuffers_txa (int channel, double* in, double* out)
+{
+	// binds the ends of the pipeline to the iobuff slots dexchange() handed out for the next xtxa()
+	setBuffers_resample (txa[channel].rsmpin.p, in, txa[channel].midbuff);
+	setBuffers_resample (txa[channel].rsmpout.p, txa[channel].midbuff, out);
+	setBuffers_meter (txa[channel].outmeter.p, out);
+}
+
 void xtxa (int channel)
 {
+	PROF_BEGIN (channel);
 	xresample (txa[channel].rsmpin.p);				// input resampler
+	PROF_MARK (channel, "rsmpin");
 	xgen (txa[channel].gen0.p);						// input signal generator
+	PROF_MARK (channel, "gen0");
 	xpanel (txa[channel].panel.p);					// includes MIC gain
+	PROF_MARK (channel, "panel");
 	xphrot (txa[channel].phrot.p);					// phase rotator
+	PROF_MARK (channel, "phrot");
 	xmeter (txa[channel].micmeter.p);				// MIC meter
+	PROF_MARK (channel, "micmeter");
 	xamsqcap (txa[channel].amsq.p);					// downward expander capture
+	PROF_MARK (channel, "amsqcap");
 	xamsq (txa[channel].amsq.p);					// downward expander action
+	PROF_MARK (channel, "amsq");
 	xeqp (txa[channel].eqp.p);						// pre-EQ
+	PROF_MARK (channel, "eqp");
 	xmeter (txa[channel].eqmeter.p);				// EQ meter
+	PROF_MARK (channel, "eqmeter");
 	xemphp (txa[channel].preemph.p, 0);				// FM pre-emphasis (first option)
+	PROF_MARK (channel, "preemph.0");
 	xwcpagc (txa[channel].leveler.p);				// Leveler
+	PROF_MARK (channel, "leveler");
 	xmeter (txa[channel].lvlrmeter.p);				// Leveler Meter
+	PROF_MARK (channel, "lvlrmeter");
 	xcfcomp (txa[channel].cfcomp.p, 0);				// Continuous Frequency Compressor with post-EQ
+	PROF_MARK (channel, "cfcomp.0");
 	xmeter (txa[channel].cfcmeter.p);				// CFC+PostEQ Meter
+	PROF_MARK (channel, "cfcmeter");
 	xbandpass (txa[channel].bp0.p, 0);				// primary bandpass filter
+	PROF_MARK (channel, "bp0.0");
 	xcompressor (txa[channel].compressor.p);		// COMP compressor
+	PROF_MARK (channel, "compressor");
 	xbandpass (txa[channel].bp1.p, 0);				// aux bandpass (runs if COMP)
+	PROF_MARK (channel, "bp1.0");
 	xosctrl (txa[channel].osctrl.p);				// CESSB Overshoot Control
+	PROF_MARK (channel, "osctrl");
 	xbandpass (txa[channel].bp2.p, 0);				// aux bandpass (runs if CESSB)
+	PROF_MARK (channel, "bp2.0");
 	xmeter (txa[channel].compmeter.p);				// COMP meter
+	PROF_MARK (channel, "compmeter");
 	xwcpagc (txa[channel].alc.p);					// ALC
+	PROF_MARK (channel, "alc");
 	xammod (txa[channel].ammod.p);					// AM Modulator
+	PROF_MARK (channel, "ammod");
 	xemphp (txa[channel].preemph.p, 1);				// FM pre-emphasis (second option)
+	PROF_MARK (channel, "preemph.1");
 	xfmmod (txa[channel].fmmod.p);					// FM Modulator
+	PROF_MARK (channel, "fmmod");
 	xgen (txa[channel].gen1.p);						// output signal generator (TUN and Two-tone)
+	PROF_MARK (channel, "gen1");
 	xuslew (txa[channel].uslew.p);					// up-slew for AM, FM, and gens
+	PROF_MARK (channel, "uslew");
 	xmeter (txa[channel].alcmeter.p);				// ALC Meter
+	PROF_MARK (channel, "alcmeter");
 	xsiphon (txa[channel].sip1.p, 0);				// siphon data for display
+	PROF_MARK (channel, "sip1.0");
 	xiqc (txa[channel].iqc.p0);						// PureSignal correction
+	PROF_MARK (channel, "iqc");
 	xcfir(txa[channel].cfir.p);						// compensating FIR filter (used Protocol_2 only)
+	PROF_MARK (channel, "cfir");
 	xresample (txa[channel].rsmpout.p);				// output resampler
+	PROF_MARK (channel, "rsmpout");
 	xmeter (txa[channel].outmeter.p);				// output meter
+	PROF_MARK (channel, "outmeter");
 	// print_peak_env ("env_exception.txt", ch[channel].dsp_outsize, txa[channel].outbuff, 0.7);
+	PROF_END (channel);
 }
 
 void setInputSamplerate_txa (int channel)
@@ -927,6 +969,16 @@ void TXASetMP (int channel, int mp)
 	SetTXAFMMP					(channel, mp);
 }
 
+PORT
+void TXASetNUP (int channel, int nup)
+{
+	int oldstate = SetChannelState (channel, 0, 1);
+	SetTXABandpassNUP			(channel, nup);
+	SetTXAEQNUP					(channel, nup);
+	SetTXACFIRNUP				(channel, nup);
+	SetChannelState (channel, oldstate, 0);
+}
+
 PORT
 void SetTXAFMAFFilter (int channel, double low, double high)
 {
@@ -170,6 +170,8 @@ extern void destroy_txa (int channel);
 
 extern void flush_txa (int channel);
 
+extern void setBuffers_txa (int channel, double* in, double* out);
+
 extern void xtxa (int channel);
 
 extern int TXAUslewCheck (int channel);
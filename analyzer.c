@@ -173,15 +173,49 @@ void new_window(int disp, int type, int size, double PiAlpha)
 	}
 	a->inherent_power_gain = igsum / (double)size;
 	a->inv_enb = 1.0 / (a->inherent_power_gain * a->inv_coherent_gain * a->inv_coherent_gain);
+	if (a->precision == dPREC_FLOAT)
+		for (i = 0; i < size; i++)
+			a->windowF[i] = (float)a->window[i];
 	// print_window_gain ("windows.txt", type, a->inv_coherent_gain, a->inherent_power_gain);
 }
 
+#define dREAL		double
+#define dCOMPLEX	fftw_complex
+#define dREAL_MAX	1.0e300
+#define dNAME(f)	f
+#include "analyzer_pixels.h"
+#undef dNAME
+#undef dREAL_MAX
+#undef dCOMPLEX
+#undef dREAL
+
+// dPREC_FLOAT analyzers store bins and pixels as floats
+#define dREAL		float
+#define dCOMPLEX	fftwf_complex
+#define dREAL_MAX	1.0e38f
+#define dNAME(f)	f##F
+#include "analyzer_pixels.h"
+#undef dNAME
+#undef dREAL_MAX
+#undef dCOMPLEX
+#undef dREAL
+
+// keeps the smaller of the new and stored power for 'n' result bins from 'k', reading the fft output
+// from bin 'i' and stepping by 'step'; returns the next result bin
+static int elim_bins (DP a, int ss, int LO, int i, int step, int k, int n)
+{
+	if (n <= 0) return k;
+	if (a->precision == dPREC_FLOAT)
+		return elim_passF (a->fft_outF[ss][LO], a->resultF[ss], a->spec_flag[ss], i, step, k, n);
+	else
+		return elim_pass (a->fft_out[ss][LO], a->result[ss], a->spec_flag[ss], i, step, k, n);
+}
+
 // spur elimination, REAL input data
 void eliminate(int disp, int ss, int LO)
 {
 	DP a = pdisp[disp];
-	int i, k, begin, end, ilim;
-	double mag;
+	int k, begin, end, ilim;
 
 	if (ss == a->begin_ss)
 		begin = a->fscL + a->clip;
@@ -195,19 +229,9 @@ void eliminate(int disp, int ss, int LO)
 	ilim = a->out_size - 1;
 
 	if (a->flip[LO])
-		for (i = ilim - begin, k = 0; i > ilim - end; i--, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		k = elim_bins (a, ss, LO, ilim - begin, -1, 0, end - begin);
 	else
-		for (i = begin, k = 0; i < end; i++, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		k = elim_bins (a, ss, LO, begin, +1, 0, end - begin);
 	a->ss_bins[ss] = k;
 }
 
@@ -215,8 +239,7 @@ void eliminate(int disp, int ss, int LO)
 void Celiminate(int disp, int ss, int LO)
 {
 	DP a = pdisp[disp];
-	int i, k, begin0, end0, begin1, end1, ilim;
-	double mag;
+	int k, begin0, end0, begin1, end1, ilim;
 
 	if (ss == a->begin_ss)
 	{
@@ -249,324 +272,269 @@ void Celiminate(int disp, int ss, int LO)
 
 	if (a->flip[LO])
 	{
-		for (i = ilim - begin0, k = 0; i > ilim - end0; i--, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
-		for (i = ilim - begin1; i > ilim - end1; i--, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		k = elim_bins (a, ss, LO, ilim - begin0, -1, 0, end0 - begin0);
+		k = elim_bins (a, ss, LO, ilim - begin1, -1, k, end1 - begin1);
 	}
 	else
 	{
-		for (i = begin0, k = 0; i < end0; i++, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
-		for (i = begin1; i < end1; i++, k++)
-		{
-			mag = (a->fft_out[ss][LO])[i][0] * (a->fft_out[ss][LO])[i][0] + (a->fft_out[ss][LO])[i][1] * (a->fft_out[ss][LO])[i][1];
-			if ((a->spec_flag[ss] == 0) || (mag < (a->result[ss])[k]))
-				(a->result[ss])[k] = mag;
-		}
+		k = elim_bins (a, ss, LO, begin0, +1, 0, end0 - begin0);
+		k = elim_bins (a, ss, LO, begin1, +1, k, end1 - begin1);
 	}
 	a->ss_bins[ss] = k;
 }
 
-void detector (	int det_type,			// detector type
-				int m,					// number of bins
-				int num_pixels,			// number of output pixels
-				double pix_per_bin,		// pixels per bin
-				double bin_per_pix,		// bins per pixel
-				double* bins,			// input buffer
-				double* pixels,			// output buffer
-				double inv_enb,			// inverse equivalent noise bandwidth
-				double fsclipL,
-				double fsclipH,
-				double det_offset
-				)
+/********************************************************************************************************
+*																										*
+*										Zero-Copy Pixel Frames											*
+*																										*
+********************************************************************************************************/
+
+// When a pixout's ring is running, stitch() renders each frame straight into a free ring slot and
+// publishes it as 'latest'.  Readers take a reference on the latest frame with AcquirePixels() and
+// give it back with ReleasePixels(); the writer never claims the latest slot or a slot with readers,
+// so a held frame stays intact.  If every other slot is held, the frame is rendered into the legacy
+// pixel buffer instead and counted as dropped.
+
+double pixel_time (void)
 {
-	int i, imin, ilim;
-	int pix_count = 0;
-	int rose, fell, next_pix_count, bcount, last_pix_count;
-	double prev_maxi, mini, maxi, psum;
-	if (pix_per_bin <= 1.0)
+	// seconds from an arbitrary origin
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER t;
+	if (freq.QuadPart == 0) QueryPerformanceFrequency (&freq);
+	QueryPerformanceCounter (&t);
+	return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1.0e-09 * (double)ts.tv_nsec;
+#endif
+}
+
+int claim_frame (PIXRING r)
+{
+	int n, idx;
+	LONG latest = r->latest;
+	for (n = 0; n < dPIXEL_RING_SLOTS; n++)
 	{
-		if (fsclipL == floor(fsclipL)) imin = 0;
-		else  imin = 1;
-		if (fsclipH == floor(fsclipH)) ilim = m;
-		else  ilim = m - 1;
-		switch (det_type)
+		idx = (r->next + n) % dPIXEL_RING_SLOTS;
+		if (idx != latest && InterlockedCompareExchange (&r->frame[idx].refs, -1, 0) == 0)
 		{
+			r->next = (idx + 1) % dPIXEL_RING_SLOTS;
+			return idx;
+		}
+	}
+	InterlockedIncrement (&r->dropped);
+	return -1;
+}
 
-		case 0:		// positive peak
-			for (i = 0; i < num_pixels; i++)
-				pixels[i]   = - 1.0e300;
+void publish_frame (PIXRING r, int idx, int num_pixels, int hold)
+{
+	// 'hold' leaves a reference on the frame for the callback
+	pixframe* f = &r->frame[idx];
+	f->seq = ++r->seq;
+	f->timestamp = pixel_time ();
+	f->num_pixels = num_pixels;
+	WriteRelease (&f->refs, hold);
+	InterlockedExchange (&r->latest, idx);
+}
 
-			for (i = imin; i < ilim; i++)
-			{
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (bins[i] > pixels[pix_count])
-					pixels[pix_count] = bins[i];
-			}
+pixframe* acquire_frame (PIXRING r, unsigned long long after_seq)
+{
+	LONG idx, refs;
+	pixframe* f;
+	for (;;)
+	{
+		idx = ReadAcquire (&r->latest);
+		if (idx < 0) return 0;
+		f = &r->frame[idx];
+		refs = ReadAcquire (&f->refs);
+		// a negative count means the slot was reclaimed after we read 'latest'; look again
+		if (refs >= 0 && InterlockedCompareExchange (&f->refs, refs + 1, refs) == refs)
 			break;
+	}
+	if (f->seq <= after_seq)
+	{
+		InterlockedDecrement (&f->refs);
+		return 0;
+	}
+	return f;
+}
 
-		case 1:		// rosenfell
-			rose         = 0;
-			fell         = 0;
-			mini         = + 1.0e300;
-			maxi         = - 1.0e300;
-			prev_maxi    = - 1.0e300;
+PIXRING get_ring (DP a, int pixout)
+{
+	// rings are only freed with the analyzer, so a reader that sees one may keep using it
+	PIXRING r;
+	int i;
+	EnterCriticalSection (&a->ResampleSection);
+	if ((r = a->ring[pixout]) == 0)
+	{
+		r = (PIXRING) malloc0 (sizeof (pixring));
+		r->latest = -1;
+		for (i = 0; i < dPIXEL_RING_SLOTS; i++)
+			r->frame[i].pixels = (dOUTREAL*) malloc0 (sizeof (dOUTREAL) * dMAX_PIXELS);
+		a->ring[pixout] = r;
+	}
+	LeaveCriticalSection (&a->ResampleSection);
+	return r;
+}
 
-			for (i = imin; i < ilim; i++)		// for each FFT bin
-			{
-				// determine the pixel number that this FFT bin goes into
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				// determine the pixel number for the NEXT FFT bin
-				next_pix_count = (int)((double)(i + 1) * pix_per_bin);
-				// update the minimum and maximum of the set of bins within the pixel
-				if (bins[i] <   mini)     mini = bins[i];
-				if (bins[i] >   maxi)     maxi = bins[i];
-				// if the next bin is also within the pixel && there is a next bin,
-				//    compare its value with the current bin and update rose and fell
-				if (next_pix_count == pix_count && i < ilim - 1)
-				{
-					// NOTE:  when next_pix_count != pix_count, rose and fell do not get updated;
-					//    that's OK because we do NOT need to know if there's a rise or fall across bins
-					if (bins[i + 1] > bins[i]) rose    = 1;
-					if (bins[i + 1] < bins[i]) fell    = 1;
-				}
-				// if the next bin is NOT within the pixel || there is no next bin, finalize the pixel 
-				//    value and reset parameters
-				else
-				{
-					if (rose && fell)
-						if (pix_count & 1)				// odd pixel
-							pixels[pix_count] = max (prev_maxi, maxi);
-						else							// even pixel
-							pixels[pix_count] = mini;
-					else
-						pixels[pix_count] = maxi;
-					rose = 0;
-					fell = 0;
-					prev_maxi = maxi;
-					mini = + 1.0e300;
-					maxi = - 1.0e300;
-				}
-			}
-			break;
+void destroy_ring (PIXRING r)
+{
+	int i;
+	for (i = 0; i < dPIXEL_RING_SLOTS; i++)
+		_aligned_free (r->frame[i].pixels);
+	_aligned_free (r);
+}
 
-		case 2:		// average - adjusted for window's equivalent noise bandwidth
-			psum = 0.0;
-			bcount = 0;
-			for (i = imin; i < ilim; i++)
-			{
-				last_pix_count = pix_count;
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (pix_count == last_pix_count)
-				{
-					psum += bins[i];
-					bcount++;
-				}
-				else
-				{
-					pixels[last_pix_count] = psum / (double)bcount * inv_enb;
-					psum = bins[i];
-					bcount = 1;
-				}
-				if (i == ilim - 1)
-				{
-					pixels[pix_count] = psum / (double)bcount * inv_enb;
-				}
-			}
-			break;
+/********************************************************************************************************
+*																										*
+*											Frame History												*
+*																										*
+********************************************************************************************************/
 
-		case 3:		// sample - adjusted for window's equivalent noise bandwidth
-			bcount = 0;
-			for (i = imin; i < ilim; i++)
-			{
-				last_pix_count = pix_count;
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (pix_count == last_pix_count)
-				{
-					bcount++;
-				}
-				else
-				{
-					pixels[last_pix_count] = bins[i - bcount / 2 - 1] * inv_enb;
-					bcount = 1;
-				}
-				if (i == ilim - 1)
-				{
-					pixels[pix_count] = bins[i - bcount / 2] * inv_enb;
-				}
-			}
-			break;
+// An optional circular history of the last 'depth' frames of a pixout, filled by stitch() as each
+// frame completes, so scrollback can be served from the library.  Frames are numbered consecutively;
+// quantized formats store each pixel as a 16- or 8-bit level between 'lo' and 'hi' dB.
 
-		case 4:		// rms
-			psum = 0.0;
-			bcount = 0;
-			for (i = imin; i < ilim; i++)
-			{
-				last_pix_count = pix_count;
-				pix_count = (int)(det_offset + (double)i * pix_per_bin);
-				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
-				if (pix_count == last_pix_count)
-				{
-					psum += bins[i] * bins[i];
-					bcount++;
-				}
-				else
-				{
-					pixels[last_pix_count] = sqrt (psum / (double)bcount) * inv_enb;
-					psum = bins[i] * bins[i];
-					bcount = 1;
-				}
-				if (i == ilim - 1)
-				{
-					pixels[pix_count] = sqrt (psum / (double)bcount) * inv_enb;
-				}
-			}
-			break;
-		}
-	}
-	else
+int hist_levels (int format)
+{
+	return format == dHIST_INT16 ? 65535 : 255;
+}
+
+size_t hist_elt_size (int format)
+{
+	switch (format)
 	{
-		double frac;
-		double pix_pos = fsclipL - floor(fsclipL);
-		int ampl_comp = (det_type == 2) || (det_type == 3) || (det_type == 4);
-		for (i = 1; i < m; i++)
-		{
-			while (pix_pos < ((double)i + 1.0e-06) && pix_count < num_pixels)
-			{
-				frac = pix_pos - (double)(i - 1);
-				pixels[pix_count]   = bins[i - 1] * (1.0 - frac) + bins[i] * frac;
-				if (ampl_comp) pixels[pix_count] *= inv_enb;
-				pix_count++;
-				pix_pos += bin_per_pix;
-			}
-		}
+	case dHIST_INT16:
+		return sizeof (unsigned short);
+	case dHIST_INT8:
+		return sizeof (unsigned char);
+	default:
+		return sizeof (dOUTREAL);
 	}
-	
 }
 
-void avenger (  int av_mode,				// averaging mode
-				int num_pixels,				// number of pixels
-				int* avail_frames,			// number of available frames for window averaging
-				int num_average,			// number of frames to average within a window
-				int* av_in_idx,				// in index for av_buff
-				int* av_out_idx,			// out index for av_buff
-				double av_backmult,			// multiplier for recursive averaging
-				double scale,				// scale factor
-				double* t_pixels,			// input buffer
-				double* av_sum,				// history buffer for averaging
-				double** av_buff,			// frame buffer for window averaging
-				double* cd,					// correction factor buffer
-				int norm,					// if TRUE, normalize to one Hz bandwidth
-				double norm_oneHz,			// normalization factor to add
-				dOUTREAL* pixels			// output buffer
-	)
+void history_add (PIXHIST h, dOUTREAL* pix, int n, double timestamp)
 {
 	int i;
-	double factor;
-	switch (av_mode)
+	double v, scale;
+	EnterCriticalSection (&h->cs);
+	if (h->depth > 0)
 	{
-	case -1:	// peak-hold
-		{
-			for (i = 0; i < num_pixels; i++)
-			{
-				if (t_pixels[i] > av_sum[i])
-					av_sum[i] = t_pixels[i];
-				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * av_sum[i] + 1.0e-60));
-			}
-			break;
-		}
-	case 0:		// no averaging
-	default:
-		{
-			for (i = 0; i < num_pixels; i++)
-				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * t_pixels[i] + 1.0e-60));
-			break;
-		}
-	case 1:		// weighted averaging of linear data
+		if (n != h->width)
 		{
-			double onem_avb = 1.0 - av_backmult;
-			for (i = 0; i < num_pixels; i++)
-			{
-				av_sum[i] = av_backmult * av_sum[i] + onem_avb * t_pixels[i];
-				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * av_sum[i] + 1.0e-60));
-			}
-			break;
+			_aligned_free (h->data);
+			h->width = n;
+			h->data = malloc0 (h->depth * h->width * hist_elt_size (h->format));
+			h->in_idx = 0;
+			h->count = 0;
 		}
-	case 2:		// window averaging of linear data
+		switch (h->format)
 		{
-			if (*avail_frames < num_average)
+		case dHIST_INT16:
+		case dHIST_INT8:
+			scale = (double)hist_levels (h->format) / (h->hi - h->lo);
+			for (i = 0; i < n; i++)
 			{
-				factor = scale / (double)++(*avail_frames);
-				for (i = 0; i < num_pixels; i++)
-				{
-					av_sum[i] += t_pixels[i];
-					av_buff[*av_in_idx][i] = t_pixels[i];
-					pixels[i] = (dOUTREAL)(10.0 * mlog10(cd[i] * av_sum[i] * factor + 1.0e-60));
-				}
-			}
-			else
-			{
-				factor = scale / (double)(*avail_frames);
-				for (i = 0; i < num_pixels; i++)
-				{
-					av_sum[i] += t_pixels[i] - (av_buff[*av_out_idx])[i];
-					av_buff[*av_in_idx][i] = t_pixels[i];
-					pixels[i] = (dOUTREAL)(10.0 * mlog10(cd[i] * av_sum[i] * factor + 1.0e-60));
-				}
-				if (++(*av_out_idx) == dMAX_AVERAGE)
-						*av_out_idx = 0;
+				v = ((double)pix[i] - h->lo) * scale + 0.5;
+				if (v < 0.0) v = 0.0;
+				if (v > (double)hist_levels (h->format)) v = (double)hist_levels (h->format);
+				if (h->format == dHIST_INT16)
+					((unsigned short *)h->data)[h->in_idx * h->width + i] = (unsigned short)v;
+				else
+					((unsigned char *)h->data)[h->in_idx * h->width + i] = (unsigned char)v;
 			}
-			if (++(*av_in_idx) == dMAX_AVERAGE)
-				*av_in_idx = 0;
 			break;
-		}
-	case 3:		// weighted averaging of log data - looks nice, not accurate for time-varying signals
-		{
-			double onem_avb = 1.0 - av_backmult;
-			for (i = 0; i < num_pixels; i++)
-			{
-				av_sum[i] = av_backmult * av_sum[i] + onem_avb * (10.0 * mlog10(scale * cd[i] * t_pixels[i] + 1e-60));
-				pixels[i] = (dOUTREAL)av_sum[i];
-			}
+		default:
+			memcpy ((dOUTREAL *)h->data + h->in_idx * h->width, pix, n * sizeof (dOUTREAL));
 			break;
 		}
+		h->timestamp[h->in_idx] = timestamp;
+		h->seq++;
+		if (++h->in_idx == h->depth) h->in_idx = 0;
+		if (h->count < h->depth) h->count++;
+	}
+	LeaveCriticalSection (&h->cs);
+}
+
+void history_get (PIXHIST h, int slot, int n, dOUTREAL* pix)
+{
+	int i;
+	double step;
+	switch (h->format)
+	{
+	case dHIST_INT16:
+		step = (h->hi - h->lo) / (double)hist_levels (h->format);
+		for (i = 0; i < n; i++)
+			pix[i] = (dOUTREAL)(h->lo + step * (double)((unsigned short *)h->data)[slot * h->width + i]);
+		break;
+	case dHIST_INT8:
+		step = (h->hi - h->lo) / (double)hist_levels (h->format);
+		for (i = 0; i < n; i++)
+			pix[i] = (dOUTREAL)(h->lo + step * (double)((unsigned char *)h->data)[slot * h->width + i]);
+		break;
+	default:
+		memcpy (pix, (dOUTREAL *)h->data + slot * h->width, n * sizeof (dOUTREAL));
+		break;
+	}
+}
+
+PIXHIST get_history (DP a, int pixout)
+{
+	// like the rings, histories are only freed with the analyzer
+	PIXHIST h;
+	EnterCriticalSection (&a->ResampleSection);
+	if ((h = a->hist[pixout]) == 0)
+	{
+		h = (PIXHIST) malloc0 (sizeof (pixhist));
+		InitializeCriticalSectionAndSpinCount (&h->cs, 2500);
+		a->hist[pixout] = h;
 	}
-	if (norm)
-		for (i = 0; i < num_pixels; i++)
-			pixels[i] += (dOUTREAL)norm_oneHz;
+	LeaveCriticalSection (&a->ResampleSection);
+	return h;
+}
+
+void destroy_history (PIXHIST h)
+{
+	_aligned_free (h->data);
+	_aligned_free (h->timestamp);
+	DeleteCriticalSection (&h->cs);
+	_aligned_free (h);
 }
 
 void stitch(int disp)
 {
 	DP a = pdisp[disp];
-	int i, j, k, n, m;
+	int i, j, k, n, m, f, ringing, hold;
 	double* ptr;
+	dOUTREAL* out;
+	PIXRING r;
+	PIXHIST h;
+	PIXEL_CALLBACK callback = 0;
+	void* callback_arg = 0;
 
 	// stitch
 	m = 0;
-	ptr = a->pre_av_out;
-	for (n = a->begin_ss; n <= a->end_ss; n++)
+	if (a->precision == dPREC_FLOAT)
+	{
+		float* ptrF = a->pre_av_outF;
+		for (n = a->begin_ss; n <= a->end_ss; n++)
+		{
+			memcpy(ptrF, a->resultF[n], a->ss_bins[n] * sizeof(float));
+			ptrF += a->ss_bins[n];
+			m += a->ss_bins[n];
+		}
+	}
+	else
 	{
-		memcpy(ptr, a->result[n], a->ss_bins[n] * sizeof(double));
-		ptr += a->ss_bins[n];
-		m += a->ss_bins[n];
+		ptr = a->pre_av_out;
+		for (n = a->begin_ss; n <= a->end_ss; n++)
+		{
+			memcpy(ptr, a->result[n], a->ss_bins[n] * sizeof(double));
+			ptr += a->ss_bins[n];
+			m += a->ss_bins[n];
+		}
 	}
 	for (i = 0; i < a->num_pixout; i++)	// for each output
 	{
@@ -580,18 +548,59 @@ void stitch(int disp)
 				k = j;
 			j--;
 		}
-		if (k == i)
-			// detect
-			detector (a->det_type[i], m, a->num_pixels, a->pix_per_bin, a->bin_per_pix, a->pre_av_out, 
-				a->t_pixels[i], a->inv_enb, a->fsclipL, a->fsclipH, a->det_offset);
+		// render into a ring slot when the ring is running, else into the legacy pixel buffer
+		out = a->pixels[i][a->w_pix_buff[i]];
+		f = -1;
+		hold = 0;
+		if ((ringing = (r = a->ring[i]) && r->run) && (f = claim_frame (r)) >= 0)
+			out = r->frame[f].pixels;
+		if (a->precision == dPREC_FLOAT)
+		{
+			if (k == i)
+				detectorF (a->det_type[i], m, a->num_pixels, a->pix_per_bin, a->bin_per_pix, a->pre_av_outF, 
+					a->t_pixelsF[i], a->inv_enb, a->fsclipL, a->fsclipH, a->det_offset);
+			else
+				memcpy (a->t_pixelsF[i], a->t_pixelsF[k], a->num_pixels * sizeof (float));
+			avengerF (a->av_mode[i], a->num_pixels, &a->avail_frames[i], a->num_average[i], &a->av_in_idx[i], &a->av_out_idx[i],
+				a->av_backmult[i], a->scale, a->t_pixelsF[i], a->av_sumF[i], a->av_buffF[i], a->cd, a->normalize[i], a->norm_oneHz,
+				out);
+		}
 		else
-			memcpy (a->t_pixels[i], a->t_pixels[k], a->num_pixels * sizeof (double));
-		// average & convert to dBm
-		avenger (a->av_mode[i], a->num_pixels, &a->avail_frames[i], a->num_average[i], &a->av_in_idx[i], &a->av_out_idx[i],
-			a->av_backmult[i], a->scale, a->t_pixels[i], a->av_sum[i], a->av_buff[i], a->cd, a->normalize[i], a->norm_oneHz,
-			a->pixels[i][a->w_pix_buff[i]]);
+		{
+			if (k == i)
+				// detect
+				detector (a->det_type[i], m, a->num_pixels, a->pix_per_bin, a->bin_per_pix, a->pre_av_out, 
+					a->t_pixels[i], a->inv_enb, a->fsclipL, a->fsclipH, a->det_offset);
+			else
+				memcpy (a->t_pixels[i], a->t_pixels[k], a->num_pixels * sizeof (double));
+			// average & convert to dBm
+			avenger (a->av_mode[i], a->num_pixels, &a->avail_frames[i], a->num_average[i], &a->av_in_idx[i], &a->av_out_idx[i],
+				a->av_backmult[i], a->scale, a->t_pixels[i], a->av_sum[i], a->av_buff[i], a->cd, a->normalize[i], a->norm_oneHz,
+				out);
+		}
+		if (f >= 0)
+		{
+			if ((callback = r->callback))
+			{
+				callback_arg = r->callback_arg;
+				hold = 1;
+			}
+			publish_frame (r, f, a->num_pixels, hold);
+		}
+		if ((h = a->hist[i]) && h->depth > 0)
+			history_add (h, out, a->num_pixels, f >= 0 ? r->frame[f].timestamp : pixel_time ());
 		LeaveCriticalSection(&a->ResampleSection);
 
+		if (ringing)
+		{
+			if (hold)
+			{
+				(*callback)(callback_arg, disp, i, out, r->frame[f].num_pixels, r->frame[f].seq, r->frame[f].timestamp);
+				InterlockedDecrement (&r->frame[f].refs);
+			}
+			continue;
+		}
+
 		EnterCriticalSection(&a->PB_ControlsSection[i]);
 			a->last_pix_buff[i] = a->w_pix_buff[i];	
 			while ((a->w_pix_buff[i] = (a->w_pix_buff[i] + 1) % dNUM_PIXEL_BUFFS) == a->r_pix_buff[i]);
@@ -600,6 +609,49 @@ void stitch(int disp)
 	}
 }
 
+/********************************************************************************************************
+*																										*
+*											Dispatch													*
+*																										*
+********************************************************************************************************/
+
+// A dispatcher (sendbuf) is queued to the worker pool only when an input buffer holds enough samples for
+// an fft, either when the samples arrive (commit_input) or when the fft jobs of the previous frame
+// finish while more samples are waiting.  It queues the fft jobs and returns; nothing polls.  Shutdown
+// waits on 'hIdle', which the last dispatcher or fft job to finish signals once 'end_dispatcher' or
+// 'stop' is set.
+
+DWORD WINAPI sendbuf(void *arg);
+
+int sendbuf_pending (DP a);
+
+void fft_done (DP a)
+{
+	if (InterlockedDecrement(a->pnum_threads) == 0 && a->stop)
+		SetEvent(a->hIdle);
+}
+
+void kick_sendbuf (int disp)
+{
+	DP a = pdisp[disp];
+	if (!a->end_dispatcher && !InterlockedBitTestAndSet(&a->dispatcher, 0))
+		QueueUserWorkItem(sendbuf, (void *)(uintptr_t)disp, 0);
+}
+
+void quiesce_analyzer (DP a)
+{
+	// stop dispatching and wait for the dispatcher and all fft jobs to finish; the timeout is only a backstop
+	ResetEvent(a->hIdle);
+	a->end_dispatcher = 1;
+	MemoryBarrier();
+	while (InterlockedAnd(&a->dispatcher, 1))
+		WaitForSingleObject(a->hIdle, 10);
+	a->stop = 1;
+	MemoryBarrier();
+	while (_InterlockedAnd(a->pnum_threads, 1023))
+		WaitForSingleObject(a->hIdle, 10);
+}
+
 DWORD WINAPI spectra (void *pargs)
 {
 	int i, j;
@@ -610,29 +662,40 @@ DWORD WINAPI spectra (void *pargs)
 
 	if (a->stop)
 	{
-		InterlockedDecrement(a->pnum_threads);
+		fft_done(a);
 		return 0;
 	}
 
 	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
 	{
-		for (i = 0; i < a->size; i++)
-		{
-			(a->fft_in[ss][LO])[i] = a->window[i] * (double)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
-			if(++a->IQO_idx[ss][LO] >= a->bsize)
-				 a->IQO_idx[ss][LO] -= a->bsize;
-		}
+		if (a->precision == dPREC_FLOAT)
+			for (i = 0; i < a->size; i++)
+			{
+				(a->fft_inF[ss][LO])[i] = a->windowF[i] * (float)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
+				if(++a->IQO_idx[ss][LO] >= a->bsize)
+					 a->IQO_idx[ss][LO] -= a->bsize;
+			}
+		else
+			for (i = 0; i < a->size; i++)
+			{
+				(a->fft_in[ss][LO])[i] = a->window[i] * (double)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
+				if(++a->IQO_idx[ss][LO] >= a->bsize)
+					 a->IQO_idx[ss][LO] -= a->bsize;
+			}
 
 		if (a->stop)
 		{
-			InterlockedDecrement(a->pnum_threads);
+			fft_done(a);
 			return 0;
 		}
-		fftw_execute (a->plan[ss][LO]);
+		if (a->precision == dPREC_FLOAT)
+			fftwf_execute (a->planF[ss][LO]);
+		else
+			fftw_execute (a->plan[ss][LO]);
 	}
 	if (a->stop)
 	{
-		InterlockedDecrement(a->pnum_threads);
+		fft_done(a);
 		return 0;
 	}
 
@@ -657,6 +720,8 @@ DWORD WINAPI spectra (void *pargs)
 				for (i = 0; i < dMAX_NUM_FFT; i++)
 					InterlockedBitTestAndReset(&(a->input_busy[j][i]), 0);
 			stitch(disp);
+			if (sendbuf_pending(a))
+				kick_sendbuf(disp);
 		}
 		else
 			LeaveCriticalSection(&a->StitchSection);
@@ -664,7 +729,7 @@ DWORD WINAPI spectra (void *pargs)
 	else
 		LeaveCriticalSection (&(a->EliminateSection[ss]));
 
-	InterlockedDecrement(a->pnum_threads);
+	fft_done(a);
 	return 1;
 }
 
@@ -793,17 +858,34 @@ void DetectMaxBin(int disp, int ss, int LO)
 	if (a->dmb_run && disp == a->dmb_disp && ss == a->dmb_ss && LO == a->dmb_LO)
 	{
 		fftw_complex* fft_out = a->fft_out[ss][LO];
+		fftwf_complex* fft_outF = a->fft_outF[ss][LO];
 		dmb_max = 1.0e-60;
 		EnterCriticalSection(&a->cs_dmb);
-		for (i = a->dmb_begin0; i <= a->dmb_end0; i++)
+		if (a->precision == dPREC_FLOAT)
 		{
-			mag = fft_out[i][0] * fft_out[i][0] + fft_out[i][1] * fft_out[i][1];
-			if (mag > dmb_max) dmb_max = mag;
+			for (i = a->dmb_begin0; i <= a->dmb_end0; i++)
+			{
+				mag = fft_outF[i][0] * fft_outF[i][0] + fft_outF[i][1] * fft_outF[i][1];
+				if (mag > dmb_max) dmb_max = mag;
+			}
+			for (i = a->dmb_begin1; i <= a->dmb_end1; i++)
+			{
+				mag = fft_outF[i][0] * fft_outF[i][0] + fft_outF[i][1] * fft_outF[i][1];
+				if (mag > dmb_max) dmb_max = mag;
+			}
 		}
-		for (i = a->dmb_begin1; i <= a->dmb_end1; i++)
+		else
 		{
-			mag = fft_out[i][0] * fft_out[i][0] + fft_out[i][1] * fft_out[i][1];
-			if (mag > dmb_max) dmb_max = mag;
+			for (i = a->dmb_begin0; i <= a->dmb_end0; i++)
+			{
+				mag = fft_out[i][0] * fft_out[i][0] + fft_out[i][1] * fft_out[i][1];
+				if (mag > dmb_max) dmb_max = mag;
+			}
+			for (i = a->dmb_begin1; i <= a->dmb_end1; i++)
+			{
+				mag = fft_out[i][0] * fft_out[i][0] + fft_out[i][1] * fft_out[i][1];
+				if (mag > dmb_max) dmb_max = mag;
+			}
 		}
 
 		a->dmb_max_dB -= fabs((1.0 - a->dmb_decay) * a->dmb_max_dB);
@@ -845,26 +927,38 @@ DWORD WINAPI Cspectra (void *pargs)
 
 	if (a->stop)
 	{
-		InterlockedDecrement(a->pnum_threads);
+		fft_done(a);
 		return 0;
 	}
 
 	if ((ss >= a->begin_ss) && (ss <= a->end_ss))
 	{
-		for (i = 0; i < a->size; i++)
-		{
-			(a->Cfft_in[ss][LO])[i][0] = a->window[i] * (double)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
-			(a->Cfft_in[ss][LO])[i][1] = a->window[i] * (double)((a->Q_samples[ss][LO])[a->IQO_idx[ss][LO]]);
-			if(++a->IQO_idx[ss][LO] >= a->bsize)
-				 a->IQO_idx[ss][LO] -= a->bsize;
-		}
+		if (a->precision == dPREC_FLOAT)
+			for (i = 0; i < a->size; i++)
+			{
+				(a->Cfft_inF[ss][LO])[i][0] = a->windowF[i] * (float)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
+				(a->Cfft_inF[ss][LO])[i][1] = a->windowF[i] * (float)((a->Q_samples[ss][LO])[a->IQO_idx[ss][LO]]);
+				if(++a->IQO_idx[ss][LO] >= a->bsize)
+					 a->IQO_idx[ss][LO] -= a->bsize;
+			}
+		else
+			for (i = 0; i < a->size; i++)
+			{
+				(a->Cfft_in[ss][LO])[i][0] = a->window[i] * (double)((a->I_samples[ss][LO])[a->IQO_idx[ss][LO]]);
+				(a->Cfft_in[ss][LO])[i][1] = a->window[i] * (double)((a->Q_samples[ss][LO])[a->IQO_idx[ss][LO]]);
+				if(++a->IQO_idx[ss][LO] >= a->bsize)
+					 a->IQO_idx[ss][LO] -= a->bsize;
+			}
 
 		if (a->stop)
 		{
-			InterlockedDecrement(a->pnum_threads);
+			fft_done(a);
 			return 0;
 		}
-		fftw_execute (a->Cplan[ss][LO]);
+		if (a->precision == dPREC_FLOAT)
+			fftwf_execute (a->CplanF[ss][LO]);
+		else
+			fftw_execute (a->Cplan[ss][LO]);
 
 		// Detect value of Max FFT Bin in a freq range
 		DetectMaxBin(disp, ss, LO);
@@ -874,14 +968,24 @@ DWORD WINAPI Cspectra (void *pargs)
 
 	if (a->stop)
 	{
-		InterlockedDecrement(a->pnum_threads);
+		fft_done(a);
 		return 0;
 	}
 
 	if (InterlockedBitTestAndReset(&(a->snap[ss][LO]), 0))
 	{
-		memcpy((char *)(a->snap_buff[ss][LO]), (char *)(a->fft_out[ss][LO]) + trans_size, trans_size);
-		memcpy((char *)(a->snap_buff[ss][LO]) + trans_size, (char *)(a->fft_out[ss][LO]), trans_size);
+		if (a->precision == dPREC_FLOAT)
+			for (i = 0; i < a->size; i++)
+			{
+				j = (i + a->size / 2) % a->size;
+				a->snap_buff[ss][LO][2 * i + 0] = (double)(a->fft_outF[ss][LO])[j][0];
+				a->snap_buff[ss][LO][2 * i + 1] = (double)(a->fft_outF[ss][LO])[j][1];
+			}
+		else
+		{
+			memcpy((char *)(a->snap_buff[ss][LO]), (char *)(a->fft_out[ss][LO]) + trans_size, trans_size);
+			memcpy((char *)(a->snap_buff[ss][LO]) + trans_size, (char *)(a->fft_out[ss][LO]), trans_size);
+		}
 		SetEvent(a->hSnapEvent[ss][LO]);
 	}
 
@@ -906,6 +1010,8 @@ DWORD WINAPI Cspectra (void *pargs)
 				for (i = 0; i < dMAX_NUM_FFT; i++)
 					InterlockedBitTestAndReset(&(a->input_busy[j][i]), 0);
 			stitch(disp);
+			if (sendbuf_pending(a))
+				kick_sendbuf(disp);
 		}
 		else
 			LeaveCriticalSection(&a->StitchSection);
@@ -913,7 +1019,7 @@ DWORD WINAPI Cspectra (void *pargs)
 	else
 		LeaveCriticalSection (&(a->EliminateSection[ss]));
 
-	InterlockedDecrement(a->pnum_threads);
+	fft_done(a);
 	return 1;
 }
 
@@ -1055,39 +1161,86 @@ int build_interpolants(int disp, int set, int n, int m, double *x, double (*y)[d
     return 0;
 }
 
-void __cdecl sendbuf(void *arg)
+int sendbuf_pending (DP a)
+{
+	int i, j;
+	for (i = 0; i < a->num_stitch; i++)
+		for (j = 0; j < a->num_fft; j++)
+			if (!_InterlockedAnd(&(a->input_busy[i][j]), 1) && _InterlockedAnd(&(a->buff_ready[i][j]), 1))
+				return 1;
+	return 0;
+}
+
+DWORD WINAPI sendbuf(void *arg)
 {
 	DP a = pdisp[(int)(uintptr_t)arg];
-	while(!a->end_dispatcher)
+	int sent;
+	for (;;)
 	{
-		for (a->ss = 0; a->ss < a->num_stitch; a->ss++)
-			for (a->LO = 0; a->LO < a->num_fft; a->LO++)
-			{
-				if (!_InterlockedAnd(&(a->input_busy[a->ss][a->LO]), 1) && _InterlockedAnd(&(a->buff_ready[a->ss][a->LO]), 1))
+		sent = 0;
+		if (!a->end_dispatcher)
+			for (a->ss = 0; a->ss < a->num_stitch; a->ss++)
+				for (a->LO = 0; a->LO < a->num_fft; a->LO++)
 				{
-					InterlockedBitTestAndSet(&(a->input_busy[a->ss][a->LO]), 0);
-
-					a->IQO_idx[a->ss][a->LO] = a->IQout_index[a->ss][a->LO];
-					
-					InterlockedIncrement(a->pnum_threads);
-					if (a->type == 0)
-						QueueUserWorkItem(spectra, (void *)(((uintptr_t)arg << 12) + (a->ss << 4) + a->LO), 0);
-					else
-						QueueUserWorkItem(Cspectra, (void *)(((uintptr_t)arg << 12) + (a->ss << 4) + a->LO), 0);
-
-					if((a->IQout_index[a->ss][a->LO] += a->incr) >= a->bsize)
-						a->IQout_index[a->ss][a->LO] -= a->bsize;
-
-					EnterCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
-					if ((a->have_samples[a->ss][a->LO] -= a->incr) < a->size)
-						InterlockedBitTestAndReset(&(a->buff_ready[a->ss][a->LO]), 0);
-					LeaveCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
+					if (!_InterlockedAnd(&(a->input_busy[a->ss][a->LO]), 1) && _InterlockedAnd(&(a->buff_ready[a->ss][a->LO]), 1))
+					{
+						InterlockedBitTestAndSet(&(a->input_busy[a->ss][a->LO]), 0);
+
+						a->IQO_idx[a->ss][a->LO] = a->IQout_index[a->ss][a->LO];
+						
+						InterlockedIncrement(a->pnum_threads);
+						if (a->type == 0)
+							QueueUserWorkItem(spectra, (void *)(((uintptr_t)arg << 12) + (a->ss << 4) + a->LO), 0);
+						else
+							QueueUserWorkItem(Cspectra, (void *)(((uintptr_t)arg << 12) + (a->ss << 4) + a->LO), 0);
+
+						if((a->IQout_index[a->ss][a->LO] += a->incr) >= a->bsize)
+							a->IQout_index[a->ss][a->LO] -= a->bsize;
+
+						EnterCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
+						if ((a->have_samples[a->ss][a->LO] -= a->incr) < a->size)
+							InterlockedBitTestAndReset(&(a->buff_ready[a->ss][a->LO]), 0);
+						LeaveCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
+						sent = 1;
+					}
 				}
-			}
-		Sleep(1);
+		if (sent)
+			continue;
+		// nothing left to send:  return the worker to the pool.  A buffer may have become ready after
+		// the last pass but while 'dispatcher' was still set, in which case nobody queued a new
+		// dispatcher for it; pick it up here unless another dispatcher has already been queued.
+		InterlockedBitTestAndReset(&a->dispatcher, 0);
+		if (a->end_dispatcher || !sendbuf_pending(a) || InterlockedBitTestAndSet(&a->dispatcher, 0))
+			break;
 	}
-	InterlockedBitTestAndReset(&a->dispatcher, 0);
-	_endthread();
+	if (a->end_dispatcher)
+		SetEvent(a->hIdle);
+	return 0;
+}
+
+void commit_input (int disp, int ss, int LO)
+{
+	// account for 'buff_size' new samples in input buffer [ss][LO]; start a dispatcher if an fft is due
+	DP a = pdisp[disp];
+	int ready;
+	EnterCriticalSection(&a->SetAnalyzerSection);
+	EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
+		if (a->have_samples[ss][LO] > a->max_writeahead)
+			{
+				//if we're receiving samples too much faster than we're consuming them, skip some
+				if ((a->IQout_index[ss][LO] += a->have_samples[ss][LO] - a->max_writeahead) >= a->bsize)
+						a->IQout_index[ss][LO] -= a->bsize;
+				a->have_samples[ss][LO] = a->max_writeahead;
+			}
+		if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
+			InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
+		ready = _InterlockedAnd(&(a->buff_ready[ss][LO]), 1) && !_InterlockedAnd(&(a->input_busy[ss][LO]), 1);
+	LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
+	if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
+		a->IQin_index[ss][LO] = 0;
+	LeaveCriticalSection(&a->SetAnalyzerSection);
+	if (ready)
+		kick_sendbuf(disp);
 }
 
 void CalcBandwidthNormalization (DP a)
@@ -1097,6 +1250,17 @@ void CalcBandwidthNormalization (DP a)
 	a->norm_oneHz = 10.0 * mlog10 (1.0 / bin_width);
 }
 
+static void set_av_sum (DP a, int pixout, double val)
+{
+	int i;
+	if (a->precision == dPREC_FLOAT)
+		for (i = 0; i < dMAX_PIXELS; i++)
+			a->av_sumF[pixout][i] = (float)val;
+	else
+		for (i = 0; i < dMAX_PIXELS; i++)
+			a->av_sum[pixout][i] = val;
+}
+
 PORT    
 void ResetPixelBuffers(int disp)
 {
@@ -1108,16 +1272,24 @@ void ResetPixelBuffers(int disp)
     EnterCriticalSection(&a->ResampleSection);
     for (i = 0; i < dMAX_PIXOUTS; i++)
     {
-        for (j = 0; j < dMAX_PIXELS; j++)
-            a->t_pixels[i][j] = 0.0;
-        for (j = 0; j < dMAX_AVERAGE; j++)
-            for (k = 0; k < dMAX_PIXELS; k++)
-                a->av_buff[i][j][k] = 0.0f;
+        if (a->precision == dPREC_FLOAT)
+        {
+            memset((void*)a->t_pixelsF[i], 0, sizeof(float) * dMAX_PIXELS);
+            for (j = 0; j < dMAX_AVERAGE; j++)
+                memset((void*)a->av_buffF[i][j], 0, sizeof(float) * dMAX_PIXELS);
+        }
+        else
+        {
+            for (j = 0; j < dMAX_PIXELS; j++)
+                a->t_pixels[i][j] = 0.0;
+            for (j = 0; j < dMAX_AVERAGE; j++)
+                for (k = 0; k < dMAX_PIXELS; k++)
+                    a->av_buff[i][j][k] = 0.0f;
+        }
         switch (a->av_mode[i])
         {
         case 1:
-            for (j = 0; j < dMAX_PIXELS; j++)
-                a->av_sum[i][j] = 1.0e-12;
+            set_av_sum(a, i, 1.0e-12);
             break;
         case 2:
             //done below
@@ -1126,11 +1298,10 @@ void ResetPixelBuffers(int disp)
             //a->av_out_idx[i] = 0;
             break;
         case 3:
-            for (j = 0; j < dMAX_PIXELS; j++)
-                a->av_sum[i][j] = -160.0;
+            set_av_sum(a, i, -160.0);
             break;
         default:
-            memset((void*)a->av_sum[i], 0, sizeof(double) * dMAX_PIXELS);
+            set_av_sum(a, i, 0.0);
             break;
         }
         a->avail_frames[i] = 0;
@@ -1144,7 +1315,10 @@ void ResetPixelBuffers(int disp)
             a->pb_ready[i][j] = 0;
         LeaveCriticalSection(&a->PB_ControlsSection[i]);
     }
-    memset((void*)a->pre_av_out, 0, sizeof(double) * a->max_size * a->max_stitch);
+    if (a->precision == dPREC_FLOAT)
+        memset((void*)a->pre_av_outF, 0, sizeof(float) * a->max_size * a->max_stitch);
+    else
+        memset((void*)a->pre_av_out, 0, sizeof(double) * a->max_size * a->max_stitch);
     LeaveCriticalSection(&a->ResampleSection);
     EnterCriticalSection(&a->StitchSection);
     for (i = 0; i < dMAX_STITCH; i++)
@@ -1195,12 +1369,7 @@ void SetAnalyzer (	int disp,			// display identifier
 	int i, j;
 
 	EnterCriticalSection(&a->SetAnalyzerSection);
-	a->end_dispatcher = 1;
-	while (InterlockedAnd(&a->dispatcher, 1))
-		Sleep(1);
-	a->stop = 1;
-	while (_InterlockedAnd(a->pnum_threads, 1023))
-		Sleep(1);
+	quiesce_analyzer(a);
 	a->num_pixout = n_pixout;
 	a->num_fft = n_fft;
 	a->type = typ;
@@ -1218,10 +1387,21 @@ void SetAnalyzer (	int disp,			// display identifier
 		for (i = 0; i < a->max_stitch; i++)
 			for (j = 0; j < a->max_num_fft; j++)
 			{
-				if (a->plan[i][j])		fftw_destroy_plan (a->plan[i][j]);
-				if (a->Cplan[i][j])		fftw_destroy_plan (a->Cplan[i][j]);
-				a->plan[i][j] = fftw_plan_dft_r2c_1d(sz, a->fft_in[i][j], a->fft_out[i][j], FFTW_PATIENT);
-				a->Cplan[i][j] = fftw_plan_dft_1d(sz, a->Cfft_in[i][j], a->fft_out[i][j], FFTW_FORWARD, FFTW_PATIENT);
+				if (a->precision == dPREC_FLOAT)
+				{
+					// wisdom is only kept for double-precision plans, so measure rather than search exhaustively
+					if (a->planF[i][j])		fftwf_destroy_plan (a->planF[i][j]);
+					if (a->CplanF[i][j])	fftwf_destroy_plan (a->CplanF[i][j]);
+					a->planF[i][j] = fftwf_plan_dft_r2c_1d(sz, a->fft_inF[i][j], a->fft_outF[i][j], FFTW_MEASURE);
+					a->CplanF[i][j] = fftwf_plan_dft_1d(sz, a->Cfft_inF[i][j], a->fft_outF[i][j], FFTW_FORWARD, FFTW_MEASURE);
+				}
+				else
+				{
+					if (a->plan[i][j])		fftw_destroy_plan (a->plan[i][j]);
+					if (a->Cplan[i][j])		fftw_destroy_plan (a->Cplan[i][j]);
+					a->plan[i][j] = fftw_plan_dft_r2c_1d(sz, a->fft_in[i][j], a->fft_out[i][j], FFTW_PATIENT);
+					a->Cplan[i][j] = fftw_plan_dft_1d(sz, a->Cfft_in[i][j], a->fft_out[i][j], FFTW_FORWARD, FFTW_PATIENT);
+				}
 			}
 
 		// Setup DetectMaxBin for a 'size' change.
@@ -1324,6 +1504,19 @@ void XCreateAnalyzer(	int disp,
 						char *app_data_path
 						)
 {
+	XCreateAnalyzerEx (disp, success, m_size, m_num_fft, m_stitch, dPREC_DOUBLE, app_data_path);
+}
+
+PORT
+void XCreateAnalyzerEx(	int disp,
+						int *success,
+						int m_size,
+						int m_num_fft,
+						int m_stitch,
+						int precision,
+						char *app_data_path
+						)
+{
 
 	int i, j;
 	DP a = (DP) malloc0 (sizeof(dp));
@@ -1332,6 +1525,7 @@ void XCreateAnalyzer(	int disp,
 	a->max_size = m_size;
 	a->max_num_fft = m_num_fft;
 	a->max_stitch = m_stitch;
+	a->precision = precision;
 	
 	a->pnum_threads = (LONG*) malloc0 (sizeof (LONG));
 
@@ -1341,6 +1535,7 @@ void XCreateAnalyzer(	int disp,
 			a->hSnapEvent[i][j] = CreateEvent(NULL, FALSE, FALSE, TEXT("snap"));
 			a->snap[i][j] = 0;
 		}
+	a->hIdle = CreateEvent(NULL, FALSE, FALSE, NULL);
 	InitializeCriticalSectionAndSpinCount(&a->ResampleSection, 0);
 	InitializeCriticalSectionAndSpinCount(&a->SetAnalyzerSection, 0);
 	InitializeCriticalSectionAndSpinCount(&a->StitchSection, 0);
@@ -1355,29 +1550,58 @@ void XCreateAnalyzer(	int disp,
 
 	a->window = (double*) malloc0 (sizeof(double) * a->max_size);
 
-	for (i = 0; i < a->max_stitch; i++)
+	if (a->precision == dPREC_FLOAT)
 	{
-		a->result[i] = (double*) malloc0 (sizeof(double) * a->max_size);
-
+		a->windowF = (float*) malloc0 (sizeof(float) * a->max_size);
+		for (i = 0; i < a->max_stitch; i++)
+			a->resultF[i] = (float*) malloc0 (sizeof(float) * a->max_size);
+		for (i = 0; i < a->max_stitch; i++)
+			for (j = 0; j < a->max_num_fft; j++)
+			{
+				a->planF[i][j] = 0;
+				a->CplanF[i][j] = 0;
+				a->fft_inF[i][j]  = (float*) malloc0 (sizeof(float) * a->max_size);
+				a->Cfft_inF[i][j] = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex) * a->max_size);
+				a->fft_outF[i][j] = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex) * a->max_size);
+			}
+		a->pre_av_outF = (float*) malloc0 (sizeof(float) * a->max_size * a->max_stitch);
+		for (i = 0; i < dMAX_PIXOUTS; i++)
+		{
+			a->av_sumF[i] = (float*) malloc0 (sizeof(float) * dMAX_PIXELS);
+			for (j = 0; j < dMAX_AVERAGE; j++)
+				a->av_buffF[i][j] = (float*) malloc0 (sizeof(float) * dMAX_PIXELS);
+			a->t_pixelsF[i] = (float*) malloc0 (sizeof(float) * dMAX_PIXELS);
+		}
 	}
-	for (i = 0; i < a->max_stitch; i++)
-		for (j = 0; j < a->max_num_fft; j++)
+	else
+	{
+		for (i = 0; i < a->max_stitch; i++)
+		{
+			a->result[i] = (double*) malloc0 (sizeof(double) * a->max_size);
+
+		}
+		for (i = 0; i < a->max_stitch; i++)
+			for (j = 0; j < a->max_num_fft; j++)
+			{
+				a->plan[i][j] = 0;
+				a->Cplan[i][j] = 0;
+				a->fft_in[i][j]   = (double*) malloc0 (sizeof(double) * a->max_size);
+				a->Cfft_in[i][j]  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * a->max_size);
+				a->fft_out[i][j]  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * a->max_size);
+			}
+		a->pre_av_out = (double*) malloc0 (sizeof(double) * a->max_size * a->max_stitch);
+		for (i = 0; i < dMAX_PIXOUTS; i++)
 		{
-			a->plan[i][j] = 0;
-			a->Cplan[i][j] = 0;
-			a->fft_in[i][j]   = (double*) malloc0 (sizeof(double) * a->max_size);
-			a->Cfft_in[i][j]  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * a->max_size);
-			a->fft_out[i][j]  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * a->max_size);
+			a->av_sum[i] = (double*) malloc0 (sizeof(double) * dMAX_PIXELS);
+			for (j = 0; j < dMAX_AVERAGE; j++)
+				a->av_buff[i][j] = (double*) malloc0 (sizeof(double) * dMAX_PIXELS);
+			a->t_pixels[i] = (double*) malloc0 (sizeof(double) * dMAX_PIXELS);
 		}
-	a->pre_av_out = (double*) malloc0 (sizeof(double) * a->max_size * a->max_stitch);
+	}
 	for (i = 0; i < dMAX_PIXOUTS; i++)
 	{
 		a->det_type[i] = 0;
 		a->av_mode[i] = 0;
-		a->av_sum[i] = (double*) malloc0 (sizeof(double) * dMAX_PIXELS);
-		for (j = 0; j < dMAX_AVERAGE; j++)
-			a->av_buff[i][j] = (double*) malloc0 (sizeof(double) * dMAX_PIXELS);
-		a->t_pixels[i] = (double*) malloc0 (sizeof(double) * dMAX_PIXELS);
 		for (j = 0; j < dNUM_PIXEL_BUFFS; j++)
 			a->pixels[i][j] = (dOUTREAL*) malloc0 (sizeof(dOUTREAL) * dMAX_PIXELS);
 	}
@@ -1427,9 +1651,7 @@ void DestroyAnalyzer(int disp)
 	DP a = pdisp[disp];
 	int i, j;
 
-	a->end_dispatcher = 1;
-	while (InterlockedAnd(&a->dispatcher, 1))
-		Sleep(1);
+	quiesce_analyzer(a);
 
 	for (i = 0; i < a->max_stitch; i++)
 		for (j = 0; j < a->max_num_fft; j++)
@@ -1455,25 +1677,57 @@ void DestroyAnalyzer(int disp)
 	{
 		for (j = 0; j < dNUM_PIXEL_BUFFS; j++)
 			_aligned_free (a->pixels[i][j]);
-		_aligned_free  (a->t_pixels[i]);
-		for (j = 0; j < dMAX_AVERAGE; j++)
-			_aligned_free (a->av_buff[i][j]);
-		_aligned_free (a->av_sum[i]);
+		if (a->ring[i])
+			destroy_ring (a->ring[i]);
+		if (a->hist[i])
+			destroy_history (a->hist[i]);
 	}
-	
-	_aligned_free (a->pre_av_out);
-	for (i = 0; i < a->max_stitch; i++)
-		for (j = 0; j < a->max_num_fft; j++)
+
+	if (a->precision == dPREC_FLOAT)
+	{
+		for (i = 0; i < dMAX_PIXOUTS; i++)
 		{
-			fftw_destroy_plan (a->plan[i][j]);
-			fftw_destroy_plan (a->Cplan[i][j]);
-			fftw_free (a->Cfft_in[i][j]);
-			_aligned_free (a->fft_in[i][j]);
-			fftw_free (a->fft_out[i][j]);
+			_aligned_free  (a->t_pixelsF[i]);
+			for (j = 0; j < dMAX_AVERAGE; j++)
+				_aligned_free (a->av_buffF[i][j]);
+			_aligned_free (a->av_sumF[i]);
 		}
-	
-	for (i = 0; i < a->max_stitch; i++)
-		_aligned_free (a->result[i]);
+		_aligned_free (a->pre_av_outF);
+		for (i = 0; i < a->max_stitch; i++)
+			for (j = 0; j < a->max_num_fft; j++)
+			{
+				if (a->planF[i][j])		fftwf_destroy_plan (a->planF[i][j]);
+				if (a->CplanF[i][j])	fftwf_destroy_plan (a->CplanF[i][j]);
+				fftwf_free (a->Cfft_inF[i][j]);
+				_aligned_free (a->fft_inF[i][j]);
+				fftwf_free (a->fft_outF[i][j]);
+			}
+		for (i = 0; i < a->max_stitch; i++)
+			_aligned_free (a->resultF[i]);
+		_aligned_free (a->windowF);
+	}
+	else
+	{
+		for (i = 0; i < dMAX_PIXOUTS; i++)
+		{
+			_aligned_free  (a->t_pixels[i]);
+			for (j = 0; j < dMAX_AVERAGE; j++)
+				_aligned_free (a->av_buff[i][j]);
+			_aligned_free (a->av_sum[i]);
+		}
+		_aligned_free (a->pre_av_out);
+		for (i = 0; i < a->max_stitch; i++)
+			for (j = 0; j < a->max_num_fft; j++)
+			{
+				fftw_destroy_plan (a->plan[i][j]);
+				fftw_destroy_plan (a->Cplan[i][j]);
+				fftw_free (a->Cfft_in[i][j]);
+				_aligned_free (a->fft_in[i][j]);
+				fftw_free (a->fft_out[i][j]);
+			}
+		for (i = 0; i < a->max_stitch; i++)
+			_aligned_free (a->result[i]);
+	}
 	_aligned_free (a->window);
 
 	for (i = 0; i < dMAX_STITCH; i++)
@@ -1491,6 +1745,7 @@ void DestroyAnalyzer(int disp)
 	for (i = 0; i < a->max_stitch; i++)
 		for (j = 0; j < a->max_num_fft; j++)
 			CloseHandle(a->hSnapEvent[i][j]);
+	CloseHandle(a->hIdle);
 
 	_aligned_free ((void *) a->pnum_threads);
 
@@ -1509,6 +1764,21 @@ void GetPixels	(	int disp,
 				)
 {
 	DP a = pdisp[disp];
+	PIXRING r = a->ring[pixout];
+	pixframe* f;
+	if (r && r->run)
+	{
+		// the ring is running; copy out the newest frame not yet returned here
+		*flag = 0;
+		if ((f = acquire_frame (r, r->legacy_seq)))
+		{
+			memcpy (pix, f->pixels, f->num_pixels * sizeof(dOUTREAL));
+			r->legacy_seq = f->seq;
+			InterlockedDecrement (&f->refs);
+			*flag = 1;
+		}
+		return;
+	}
 	EnterCriticalSection(&a->PB_ControlsSection[pixout]);
 		a->r_pix_buff[pixout] = a->last_pix_buff[pixout];
 	LeaveCriticalSection(&a->PB_ControlsSection[pixout]);
@@ -1523,6 +1793,191 @@ void GetPixels	(	int disp,
 		*flag = 0;
 }
 
+PORT
+void SetDisplayPixelRing (int disp, int pixout, int run)
+{
+	// run = 1 delivers frames through the zero-copy ring (and the callback, if set); GetPixels() keeps working
+	DP a = pdisp[disp];
+	PIXRING r = get_ring (a, pixout);
+	InterlockedExchange (&r->run, run);
+}
+
+PORT
+void SetDisplayPixelCallback (int disp, int pixout, PIXEL_CALLBACK callback, void *arg)
+{
+	// called on an analyzer worker thread as each frame completes; the pixels are valid until it returns.
+	// Setting a callback starts the ring; pass a null callback to remove it.
+	DP a = pdisp[disp];
+	PIXRING r = get_ring (a, pixout);
+	EnterCriticalSection (&a->ResampleSection);
+	r->callback_arg = arg;
+	r->callback = callback;
+	LeaveCriticalSection (&a->ResampleSection);
+	if (callback)
+		InterlockedExchange (&r->run, 1);
+}
+
+PORT
+const dOUTREAL* AcquirePixels (	int disp,
+								int pixout,
+								unsigned long long after_seq,	//only return a frame newer than this
+								int *num_pixels,
+								unsigned long long *seq,
+								double *timestamp
+							  )
+{
+	// returns the newest frame by reference, or null if there is none newer than 'after_seq';
+	// the frame stays valid until it is handed back with ReleasePixels()
+	DP a = pdisp[disp];
+	PIXRING r = a->ring[pixout];
+	pixframe* f;
+	if (r == 0 || (f = acquire_frame (r, after_seq)) == 0)
+		return 0;
+	*num_pixels = f->num_pixels;
+	*seq = f->seq;
+	*timestamp = f->timestamp;
+	return f->pixels;
+}
+
+PORT
+void ReleasePixels (int disp, int pixout, const dOUTREAL *pixels)
+{
+	DP a = pdisp[disp];
+	PIXRING r = a->ring[pixout];
+	int i;
+	if (r == 0) return;
+	for (i = 0; i < dPIXEL_RING_SLOTS; i++)
+		if (r->frame[i].pixels == pixels)
+		{
+			InterlockedDecrement (&r->frame[i].refs);
+			break;
+		}
+}
+
+PORT
+void GetDisplayPixelRingStats (int disp, int pixout, unsigned long long *seq, int *dropped)
+{
+	DP a = pdisp[disp];
+	PIXRING r = a->ring[pixout];
+	*seq = 0;
+	*dropped = 0;
+	if (r == 0) return;
+	*seq = r->seq;
+	*dropped = (int)r->dropped;
+}
+
+PORT
+void SetDisplayHistory (int disp, int pixout, int depth, int format, double lo, double hi)
+{
+	// keep the last 'depth' frames of 'pixout'; depth = 0 turns the history off and frees its storage
+	DP a = pdisp[disp];
+	PIXHIST h = get_history (a, pixout);
+	EnterCriticalSection (&h->cs);
+	_aligned_free (h->data);
+	_aligned_free (h->timestamp);
+	h->data = 0;
+	h->timestamp = 0;
+	h->depth = depth > 0 ? depth : 0;
+	h->format = (format == dHIST_INT16 || format == dHIST_INT8) ? format : dHIST_FLOAT;
+	h->lo = lo;
+	h->hi = hi > lo ? hi : lo + 1.0;
+	h->width = 0;
+	h->in_idx = 0;
+	h->count = 0;
+	if (h->depth > 0)
+		h->timestamp = (double *) malloc0 (h->depth * sizeof (double));
+	LeaveCriticalSection (&h->cs);
+}
+
+PORT
+int GetDisplayHistoryRange (int disp, int pixout, unsigned long long *first_seq, unsigned long long *last_seq)
+{
+	// returns the number of pixels per stored frame; first_seq > last_seq when the history is empty
+	DP a = pdisp[disp];
+	PIXHIST h = a->hist[pixout];
+	int width = 0;
+	*first_seq = 1;
+	*last_seq = 0;
+	if (h)
+	{
+		EnterCriticalSection (&h->cs);
+		*first_seq = h->seq - h->count + 1;
+		*last_seq = h->seq;
+		width = h->width;
+		LeaveCriticalSection (&h->cs);
+	}
+	return width;
+}
+
+PORT
+unsigned long long FindDisplayHistoryFrame (int disp, int pixout, double timestamp)
+{
+	// sequence number of the oldest stored frame completed at or after 'timestamp' (seconds on the
+	// clock of the frame timestamps), or one past the newest frame if there is none
+	DP a = pdisp[disp];
+	PIXHIST h = a->hist[pixout];
+	int lo, hi, mid, oldest;
+	unsigned long long seq = 1;
+	if (h)
+	{
+		EnterCriticalSection (&h->cs);
+		oldest = (h->in_idx - h->count + h->depth) % max (h->depth, 1);
+		lo = 0;
+		hi = h->count;
+		while (lo < hi)
+		{
+			mid = (lo + hi) / 2;
+			if (h->timestamp[(oldest + mid) % h->depth] < timestamp)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		seq = h->seq - h->count + 1 + lo;
+		LeaveCriticalSection (&h->cs);
+	}
+	return seq;
+}
+
+PORT
+int GetDisplayHistory (	int disp,
+						int pixout,
+						unsigned long long from_seq,	//first frame wanted; older frames than those held are skipped
+						int max_frames,					//maximum number of frames to return
+						int stride,						//distance between frames in 'pix', in pixels
+						dOUTREAL *pix,					//receives the frames, oldest first
+						unsigned long long *seqs,		//optional, receives the frame sequence numbers
+						double *timestamps				//optional, receives the frame timestamps
+					  )
+{
+	// returns the number of frames copied
+	DP a = pdisp[disp];
+	PIXHIST h = a->hist[pixout];
+	unsigned long long first;
+	int n = 0, k, oldest, slot, width;
+	if (h == 0 || max_frames <= 0 || stride <= 0) return 0;
+	EnterCriticalSection (&h->cs);
+	if (h->count > 0)
+	{
+		first = h->seq - h->count + 1;
+		if (from_seq < first) from_seq = first;
+		if (from_seq <= h->seq)
+		{
+			n = (int)min ((unsigned long long)max_frames, h->seq - from_seq + 1);
+			oldest = (h->in_idx - h->count + h->depth) % h->depth;
+			width = min (h->width, stride);
+			for (k = 0; k < n; k++)
+			{
+				slot = (oldest + (int)(from_seq - first) + k) % h->depth;
+				history_get (h, slot, width, pix + k * stride);
+				if (seqs) seqs[k] = from_seq + k;
+				if (timestamps) timestamps[k] = h->timestamp[slot];
+			}
+		}
+	}
+	LeaveCriticalSection (&h->cs);
+	return n;
+}
+
 PORT
 void SnapSpectrum(	int disp,
 					int ss,
@@ -1611,30 +2066,7 @@ void OpenBuffer(int disp, int ss, int LO, void **Ipointer, void **Qpointer)
 PORT   
 void CloseBuffer(int disp, int ss, int LO)
 {
-	DP a = pdisp[disp];
-	EnterCriticalSection(&a->SetAnalyzerSection);
-	EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
-		if (a->have_samples[ss][LO] > a->max_writeahead)
-			{
-				//if we're receiving samples too much faster than we're consuming them, skip some
-				if ((a->IQout_index[ss][LO] += a->have_samples[ss][LO] - a->max_writeahead) >= a->bsize)
-						a->IQout_index[ss][LO] -= a->bsize;
-				a->have_samples[ss][LO] = a->max_writeahead;
-			}
-		if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-			InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
-	LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
-	if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
-		a->IQin_index[ss][LO] = 0;
-
-	if (!InterlockedAnd(&a->dispatcher, 1))
-	{
-		InterlockedBitTestAndSet (&a->dispatcher, 0);
-		LeaveCriticalSection(&a->SetAnalyzerSection);
-		_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-	}
-	else
-		LeaveCriticalSection(&a->SetAnalyzerSection);
+	commit_input(disp, ss, LO);
 }
 
 PORT
@@ -1651,29 +2083,7 @@ void Spectrum(int disp, int ss, int LO, dINREAL* pI, dINREAL* pQ)
 	memcpy(Ipointer, pI, a->buff_size * sizeof(dINREAL));
 	memcpy(Qpointer, pQ, a->buff_size * sizeof(dINREAL));
 
-	EnterCriticalSection(&a->SetAnalyzerSection);
-	EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
-		if (a->have_samples[ss][LO] > a->max_writeahead)
-			{
-				//if we're receiving samples too much faster than we're consuming them, skip some
-				if ((a->IQout_index[ss][LO] += a->have_samples[ss][LO] - a->max_writeahead) >= a->bsize)
-						a->IQout_index[ss][LO] -= a->bsize;
-				a->have_samples[ss][LO] = a->max_writeahead;
-			}
-		if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-			InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
-	LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
-	if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
-		a->IQin_index[ss][LO] = 0;
-
-	if (!InterlockedAnd(&a->dispatcher, 1))
-	{
-		InterlockedBitTestAndSet(&a->dispatcher, 0);
-		LeaveCriticalSection(&a->SetAnalyzerSection);
-		_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-	}
-	else
-		LeaveCriticalSection(&a->SetAnalyzerSection);
+	commit_input(disp, ss, LO);
 }
 
 PORT
@@ -1696,29 +2106,7 @@ void Spectrum2(int run, int disp, int ss, int LO, dINREAL* pbuff)
 			Qpointer[i] = pbuff[2 * i + 0];
 		}
 
-		EnterCriticalSection(&a->SetAnalyzerSection);
-		EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
-			if (a->have_samples[ss][LO] > a->max_writeahead)
-				{
-					//if we're receiving samples too much faster than we're consuming them, skip some
-					if ((a->IQout_index[ss][LO] += a->have_samples[ss][LO] - a->max_writeahead) >= a->bsize)
-							a->IQout_index[ss][LO] -= a->bsize;
-					a->have_samples[ss][LO] = a->max_writeahead;
-				}
-			if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-				InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
-		LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
-		if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
-			a->IQin_index[ss][LO] = 0;
-
-		if (!InterlockedAnd(&a->dispatcher, 1))
-		{
-			InterlockedBitTestAndSet(&a->dispatcher, 0);
-			LeaveCriticalSection(&a->SetAnalyzerSection);
-			_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-		}
-		else
-			LeaveCriticalSection(&a->SetAnalyzerSection);
+		commit_input(disp, ss, LO);
 	}
 }
 
@@ -1742,29 +2130,7 @@ void Spectrum0(int run, int disp, int ss, int LO, double* pbuff)
 			Qpointer[i] = (dINREAL)pbuff[2 * i + 0];
 		}
 
-		EnterCriticalSection(&a->SetAnalyzerSection);
-		EnterCriticalSection(&(a->BufferControlSection[ss][LO]));
-			if (a->have_samples[ss][LO] > a->max_writeahead)
-				{
-					//if we're receiving samples too much faster than we're consuming them, skip some
-					if ((a->IQout_index[ss][LO] += a->have_samples[ss][LO] - a->max_writeahead) >= a->bsize)
-					 	a->IQout_index[ss][LO] -= a->bsize;
-					a->have_samples[ss][LO] = a->max_writeahead;
-				}
-			if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-				InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
-		LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
-		if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize)	//REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
-			a->IQin_index[ss][LO] = 0;
-
-		if (!InterlockedAnd(&a->dispatcher, 1))
-		{
-			InterlockedBitTestAndSet(&a->dispatcher, 0);
-			LeaveCriticalSection(&a->SetAnalyzerSection);
-			_beginthread(sendbuf, 0, (void *)(uintptr_t)disp);
-		}
-		else
-			LeaveCriticalSection(&a->SetAnalyzerSection);
+		commit_input(disp, ss, LO);
 	}
 }
 
@@ -1783,7 +2149,6 @@ void SetDisplayDetectorMode (int disp, int pixout, int mode)
 PORT
 void SetDisplayAverageMode (int disp, int pixout, int mode)
 {
-	int i;
 	DP a = pdisp[disp];
 	if (a->av_mode[pixout] != mode)
 	{
@@ -1792,8 +2157,7 @@ void SetDisplayAverageMode (int disp, int pixout, int mode)
 		switch (mode)
 		{
 		case 1:
-			for (i = 0; i < dMAX_PIXELS; i++)
-				a->av_sum[pixout][i] = 1.0e-12;
+			set_av_sum (a, pixout, 1.0e-12);
 			break;
 		case 2:
 			a->avail_frames[pixout] = 0;
@@ -1801,11 +2165,10 @@ void SetDisplayAverageMode (int disp, int pixout, int mode)
 			a->av_out_idx[pixout] = 0;
 			break;
 		case 3:
-			for (i = 0; i < dMAX_PIXELS; i++)
-				a->av_sum[pixout][i] = -160.0;
+			set_av_sum (a, pixout, -160.0);
 			break;
 		default:
-			memset ((void *)a->av_sum[pixout], 0, sizeof(double) * dMAX_PIXELS);
+			set_av_sum (a, pixout, 0.0);
 			break;
 		}
 		LeaveCriticalSection (&a->ResampleSection);
@@ -28,11 +28,61 @@ warren@wpratt.com
 #define _analyzer_h
 #include "comm.h"
 
+#define dPREC_DOUBLE					0					// analyzer ffts, windows and pixel math in double precision
+#define dPREC_FLOAT						1					// analyzer ffts, windows and pixel math in single precision
+
+#define dPIXEL_RING_SLOTS				8					// pixel frames per pixout in the zero-copy ring
+
+typedef void (*PIXEL_CALLBACK)(void *arg, int disp, int pixout, const dOUTREAL *pixels, int num_pixels,
+	unsigned long long seq, double timestamp);
+
+typedef struct _pixframe
+{
+	volatile LONG refs;										// readers holding the frame; -1 while the analyzer writes it
+	unsigned long long seq;									// frame sequence number, starting at 1
+	double timestamp;										// seconds, monotonic clock, when the frame was completed
+	int num_pixels;
+	dOUTREAL *pixels;
+} pixframe;
+
+typedef struct _pixring
+{
+	volatile LONG run;										// 1 while frames are delivered through the ring
+	volatile LONG latest;									// slot of the newest complete frame, -1 if none
+	int next;												// slot at which the writer starts its search for a free one
+	unsigned long long seq;									// sequence number of the newest frame
+	unsigned long long legacy_seq;							// newest frame handed out by GetPixels()
+	volatile LONG dropped;									// frames not delivered because every slot was held
+	PIXEL_CALLBACK callback;
+	void *callback_arg;
+	pixframe frame[dPIXEL_RING_SLOTS];
+} pixring, *PIXRING;
+
+#define dHIST_FLOAT						0					// history frames stored as dOUTREAL
+#define dHIST_INT16						1					// history frames quantized to 16 bits between lo and hi dB
+#define dHIST_INT8						2					// history frames quantized to 8 bits between lo and hi dB
+
+typedef struct _pixhist
+{
+	int depth;												// number of frames kept, 0 when history is off
+	int format;												// dHIST_FLOAT, dHIST_INT16, or dHIST_INT8
+	double lo;												// dB value of the lowest quantization level
+	double hi;												// dB value of the highest quantization level
+	int width;												// pixels per stored frame; a change in num_pixels restarts the history
+	int in_idx;												// slot that receives the next frame
+	int count;												// number of frames held
+	unsigned long long seq;									// sequence number of the newest frame
+	double *timestamp;										// per-slot completion time, seconds, monotonic clock
+	void *data;												// depth * width stored pixels
+	CRITICAL_SECTION cs;
+} pixhist, *PIXHIST;
+
 typedef struct _dp
 {
 	int max_size;											// maximum fft size to be used
 	int max_num_fft;										// maximum number of LO positions per sub-span to be used
 	int max_stitch;											// maximum number of sub-spans to be concatenated
+	int precision;											// dPREC_DOUBLE or dPREC_FLOAT, fixed when the analyzer is created
 															//		NOTE:  max_size, max_num_fft, and max_stitch MUST BE <= THE
 															//		CORRESPONDING VALUES IN <analyzer.h>!!
 	int num_fft;											// current number of ffts in use
@@ -83,6 +133,8 @@ typedef struct _dp
 	double *av_buff[dMAX_PIXOUTS][dMAX_AVERAGE];			// pointers to ring of buffers to hold pixel frames for averaging
 	double *pre_av_out;
 	int av_mode[dMAX_PIXOUTS];
+	PIXRING ring[dMAX_PIXOUTS];								// zero-copy frame rings, allocated on first use
+	PIXHIST hist[dMAX_PIXOUTS];								// frame histories, allocated on first use
 	double av_backmult[dMAX_PIXOUTS];						// back multiplier for weighted averaging
 	double *cd;												// pointer to amplitude calibration buffer
 	int n_freqs[dMAX_CAL_SETS];								// number of frequencies in each calibration set
@@ -92,6 +144,20 @@ typedef struct _dp
 	double (*ac1[dMAX_CAL_SETS][dMAX_M]);
 	double (*ac0[dMAX_CAL_SETS][dMAX_M]);
 
+	// single-precision counterparts; when precision is dPREC_FLOAT these are allocated instead of
+	// fft_in, Cfft_in, fft_out, result, pre_av_out, t_pixels, av_sum, and av_buff
+	float *windowF;
+	float *resultF[dMAX_STITCH];
+	float *pre_av_outF;
+	float *t_pixelsF[dMAX_PIXOUTS];
+	float *av_sumF[dMAX_PIXOUTS];
+	float *av_buffF[dMAX_PIXOUTS][dMAX_AVERAGE];
+	fftwf_plan planF[dMAX_STITCH][dMAX_NUM_FFT];
+	fftwf_plan CplanF[dMAX_STITCH][dMAX_NUM_FFT];
+	float *fft_inF[dMAX_STITCH][dMAX_NUM_FFT];
+	fftwf_complex *Cfft_inF[dMAX_STITCH][dMAX_NUM_FFT];
+	fftwf_complex *fft_outF[dMAX_STITCH][dMAX_NUM_FFT];
+
 	fftw_plan plan[dMAX_STITCH][dMAX_NUM_FFT];				// fftw plans
 	fftw_plan Cplan[dMAX_STITCH][dMAX_NUM_FFT];
 	double *fft_in[dMAX_STITCH][dMAX_NUM_FFT];				// pointers to fftw real input vectors
@@ -119,6 +185,7 @@ typedef struct _dp
 
 	volatile LONG snap[dMAX_STITCH][dMAX_NUM_FFT];			// set to 1 to allow a snap of raw spectrum data
 	HANDLE hSnapEvent[dMAX_STITCH][dMAX_NUM_FFT];			// mutex handles; mutexes will be used to signal a snap is complete
+	HANDLE hIdle;											// signalled when the dispatcher or the last fft job ends after a stop
 	double *snap_buff[dMAX_STITCH][dMAX_NUM_FFT];			// pointers to buffers for the snap
 
 	CRITICAL_SECTION PB_ControlsSection[dMAX_PIXOUTS];
@@ -173,6 +240,16 @@ void XCreateAnalyzer (	int disp,
 						char *app_data_path
 					 );
 
+extern __declspec( dllexport )
+void XCreateAnalyzerEx (	int disp,
+						int *success,
+						int m_size,
+						int m_LO,
+						int m_stitch,
+						int precision,	//dPREC_DOUBLE or dPREC_FLOAT
+						char *app_data_path
+					 );
+
 extern __declspec( dllexport )   
 void DestroyAnalyzer(int disp);
 
@@ -212,4 +289,33 @@ void SnapSpectrumTimeout (int disp,
                           DWORD timeout,
                           int* flag);
 
+extern __declspec( dllexport )
+void SetDisplayPixelRing (int disp, int pixout, int run);
+
+extern __declspec( dllexport )
+void SetDisplayPixelCallback (int disp, int pixout, PIXEL_CALLBACK callback, void *arg);
+
+extern __declspec( dllexport )
+const dOUTREAL* AcquirePixels (int disp, int pixout, unsigned long long after_seq, int *num_pixels,
+	unsigned long long *seq, double *timestamp);
+
+extern __declspec( dllexport )
+void ReleasePixels (int disp, int pixout, const dOUTREAL *pixels);
+
+extern __declspec( dllexport )
+void GetDisplayPixelRingStats (int disp, int pixout, unsigned long long *seq, int *dropped);
+
+extern __declspec( dllexport )
+void SetDisplayHistory (int disp, int pixout, int depth, int format, double lo, double hi);
+
+extern __declspec( dllexport )
+int GetDisplayHistoryRange (int disp, int pixout, unsigned long long *first_seq, unsigned long long *last_seq);
+
+extern __declspec( dllexport )
+unsigned long long FindDisplayHistoryFrame (int disp, int pixout, double timestamp);
+
+extern __declspec( dllexport )
+int GetDisplayHistory (int disp, int pixout, unsigned long long from_seq, int max_frames, int stride,
+	dOUTREAL *pix, unsigned long long *seqs, double *timestamps);
+
 #endif
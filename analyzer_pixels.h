@@ -0,0 +1,321 @@
+/*  analyzer_pixels.h
+
+This file is part of a program that implements a Spectrum Analyzer
+used in conjunction with software-defined-radio hardware.
+
+Copyright (C) 2012, 2013, 2014, 2016, 2023, 2025 Warren Pratt, NR0V
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+The author can be reached by email at  
+
+warren@wpratt.com
+
+*/
+
+// Spur elimination, detector() and avenger(), written once for both analyzer precisions.  analyzer.c
+// includes this file twice, with these defined:
+//		dREAL		the bin and pixel storage type, double or float
+//		dCOMPLEX	the fft output type, fftw_complex or fftwf_complex
+//		dREAL_MAX	a magnitude larger than any bin value, for the peak detectors
+//		dNAME(f)	the function name for that precision, f or fF
+// Sums and the dB conversion are done in double for both.
+
+static int dNAME(elim_pass) (dCOMPLEX* out, dREAL* res, int spec_flag, int i, int step, int k, int n)
+{
+	dREAL mag;
+	int lim = k + n;
+	for (; k < lim; i += step, k++)
+	{
+		mag = out[i][0] * out[i][0] + out[i][1] * out[i][1];
+		if ((spec_flag == 0) || (mag < res[k]))
+			res[k] = mag;
+	}
+	return k;
+}
+
+void dNAME(detector) (	int det_type,			// detector type
+				int m,					// number of bins
+				int num_pixels,			// number of output pixels
+				double pix_per_bin,		// pixels per bin
+				double bin_per_pix,		// bins per pixel
+				dREAL* bins,			// input buffer
+				dREAL* pixels,			// output buffer
+				double inv_enb,			// inverse equivalent noise bandwidth
+				double fsclipL,
+				double fsclipH,
+				double det_offset
+				)
+{
+	int i, imin, ilim;
+	int pix_count = 0;
+	int rose, fell, next_pix_count, bcount, last_pix_count;
+	dREAL prev_maxi, mini, maxi;
+	double psum;
+	if (pix_per_bin <= 1.0)
+	{
+		if (fsclipL == floor(fsclipL)) imin = 0;
+		else  imin = 1;
+		if (fsclipH == floor(fsclipH)) ilim = m;
+		else  ilim = m - 1;
+		switch (det_type)
+		{
+
+		case 0:		// positive peak
+			for (i = 0; i < num_pixels; i++)
+				pixels[i]   = - dREAL_MAX;
+
+			for (i = imin; i < ilim; i++)
+			{
+				pix_count = (int)(det_offset + (double)i * pix_per_bin);
+				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+				if (bins[i] > pixels[pix_count])
+					pixels[pix_count] = bins[i];
+			}
+			break;
+
+		case 1:		// rosenfell
+			rose         = 0;
+			fell         = 0;
+			mini         = + dREAL_MAX;
+			maxi         = - dREAL_MAX;
+			prev_maxi    = - dREAL_MAX;
+
+			for (i = imin; i < ilim; i++)		// for each FFT bin
+			{
+				// determine the pixel number that this FFT bin goes into
+				pix_count = (int)(det_offset + (double)i * pix_per_bin);
+				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+				// determine the pixel number for the NEXT FFT bin
+				next_pix_count = (int)((double)(i + 1) * pix_per_bin);
+				// update the minimum and maximum of the set of bins within the pixel
+				if (bins[i] <   mini)     mini = bins[i];
+				if (bins[i] >   maxi)     maxi = bins[i];
+				// if the next bin is also within the pixel && there is a next bin,
+				//    compare its value with the current bin and update rose and fell
+				if (next_pix_count == pix_count && i < ilim - 1)
+				{
+					// NOTE:  when next_pix_count != pix_count, rose and fell do not get updated;
+					//    that's OK because we do NOT need to know if there's a rise or fall across bins
+					if (bins[i + 1] > bins[i]) rose    = 1;
+					if (bins[i + 1] < bins[i]) fell    = 1;
+				}
+				// if the next bin is NOT within the pixel || there is no next bin, finalize the pixel 
+				//    value and reset parameters
+				else
+				{
+					if (rose && fell)
+						if (pix_count & 1)				// odd pixel
+							pixels[pix_count] = max (prev_maxi, maxi);
+						else							// even pixel
+							pixels[pix_count] = mini;
+					else
+						pixels[pix_count] = maxi;
+					rose = 0;
+					fell = 0;
+					prev_maxi = maxi;
+					mini = + dREAL_MAX;
+					maxi = - dREAL_MAX;
+				}
+			}
+			break;
+
+		case 2:		// average - adjusted for window's equivalent noise bandwidth
+			psum = 0.0;
+			bcount = 0;
+			for (i = imin; i < ilim; i++)
+			{
+				last_pix_count = pix_count;
+				pix_count = (int)(det_offset + (double)i * pix_per_bin);
+				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+				if (pix_count == last_pix_count)
+				{
+					psum += bins[i];
+					bcount++;
+				}
+				else
+				{
+					pixels[last_pix_count] = (dREAL)(psum / (double)bcount * inv_enb);
+					psum = bins[i];
+					bcount = 1;
+				}
+				if (i == ilim - 1)
+				{
+					pixels[pix_count] = (dREAL)(psum / (double)bcount * inv_enb);
+				}
+			}
+			break;
+
+		case 3:		// sample - adjusted for window's equivalent noise bandwidth
+			bcount = 0;
+			for (i = imin; i < ilim; i++)
+			{
+				last_pix_count = pix_count;
+				pix_count = (int)(det_offset + (double)i * pix_per_bin);
+				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+				if (pix_count == last_pix_count)
+				{
+					bcount++;
+				}
+				else
+				{
+					pixels[last_pix_count] = (dREAL)(bins[i - bcount / 2 - 1] * inv_enb);
+					bcount = 1;
+				}
+				if (i == ilim - 1)
+				{
+					pixels[pix_count] = (dREAL)(bins[i - bcount / 2] * inv_enb);
+				}
+			}
+			break;
+
+		case 4:		// rms
+			psum = 0.0;
+			bcount = 0;
+			for (i = imin; i < ilim; i++)
+			{
+				last_pix_count = pix_count;
+				pix_count = (int)(det_offset + (double)i * pix_per_bin);
+				if (pix_count >= num_pixels) pix_count = num_pixels - 1;
+				if (pix_count == last_pix_count)
+				{
+					psum += (double)bins[i] * bins[i];
+					bcount++;
+				}
+				else
+				{
+					pixels[last_pix_count] = (dREAL)(sqrt (psum / (double)bcount) * inv_enb);
+					psum = (double)bins[i] * bins[i];
+					bcount = 1;
+				}
+				if (i == ilim - 1)
+				{
+					pixels[pix_count] = (dREAL)(sqrt (psum / (double)bcount) * inv_enb);
+				}
+			}
+			break;
+		}
+	}
+	else
+	{
+		double frac;
+		double pix_pos = fsclipL - floor(fsclipL);
+		int ampl_comp = (det_type == 2) || (det_type == 3) || (det_type == 4);
+		for (i = 1; i < m; i++)
+		{
+			while (pix_pos < ((double)i + 1.0e-06) && pix_count < num_pixels)
+			{
+				frac = pix_pos - (double)(i - 1);
+				pixels[pix_count]   = (dREAL)(bins[i - 1] * (1.0 - frac) + bins[i] * frac);
+				if (ampl_comp) pixels[pix_count] *= (dREAL)inv_enb;
+				pix_count++;
+				pix_pos += bin_per_pix;
+			}
+		}
+	}
+	
+}
+
+void dNAME(avenger) (  int av_mode,				// averaging mode
+				int num_pixels,				// number of pixels
+				int* avail_frames,			// number of available frames for window averaging
+				int num_average,			// number of frames to average within a window
+				int* av_in_idx,				// in index for av_buff
+				int* av_out_idx,			// out index for av_buff
+				double av_backmult,			// multiplier for recursive averaging
+				double scale,				// scale factor
+				dREAL* t_pixels,			// input buffer
+				dREAL* av_sum,				// history buffer for averaging
+				dREAL** av_buff,			// frame buffer for window averaging
+				double* cd,					// correction factor buffer
+				int norm,					// if TRUE, normalize to one Hz bandwidth
+				double norm_oneHz,			// normalization factor to add
+				dOUTREAL* pixels			// output buffer
+	)
+{
+	int i;
+	double factor;
+	switch (av_mode)
+	{
+	case -1:	// peak-hold
+		{
+			for (i = 0; i < num_pixels; i++)
+			{
+				if (t_pixels[i] > av_sum[i])
+					av_sum[i] = t_pixels[i];
+				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * av_sum[i] + 1.0e-60));
+			}
+			break;
+		}
+	case 0:		// no averaging
+	default:
+		{
+			for (i = 0; i < num_pixels; i++)
+				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * t_pixels[i] + 1.0e-60));
+			break;
+		}
+	case 1:		// weighted averaging of linear data
+		{
+			double onem_avb = 1.0 - av_backmult;
+			for (i = 0; i < num_pixels; i++)
+			{
+				av_sum[i] = (dREAL)(av_backmult * av_sum[i] + onem_avb * t_pixels[i]);
+				pixels[i] = (dOUTREAL)(10.0 * mlog10(scale * cd[i] * av_sum[i] + 1.0e-60));
+			}
+			break;
+		}
+	case 2:		// window averaging of linear data
+		{
+			if (*avail_frames < num_average)
+			{
+				factor = scale / (double)++(*avail_frames);
+				for (i = 0; i < num_pixels; i++)
+				{
+					av_sum[i] += t_pixels[i];
+					av_buff[*av_in_idx][i] = t_pixels[i];
+					pixels[i] = (dOUTREAL)(10.0 * mlog10(cd[i] * av_sum[i] * factor + 1.0e-60));
+				}
+			}
+			else
+			{
+				factor = scale / (double)(*avail_frames);
+				for (i = 0; i < num_pixels; i++)
+				{
+					av_sum[i] += t_pixels[i] - (av_buff[*av_out_idx])[i];
+					av_buff[*av_in_idx][i] = t_pixels[i];
+					pixels[i] = (dOUTREAL)(10.0 * mlog10(cd[i] * av_sum[i] * factor + 1.0e-60));
+				}
+				if (++(*av_out_idx) == dMAX_AVERAGE)
+						*av_out_idx = 0;
+			}
+			if (++(*av_in_idx) == dMAX_AVERAGE)
+				*av_in_idx = 0;
+			break;
+		}
+	case 3:		// weighted averaging of log data - looks nice, not accurate for time-varying signals
+		{
+			double onem_avb = 1.0 - av_backmult;
+			for (i = 0; i < num_pixels; i++)
+			{
+				av_sum[i] = (dREAL)(av_backmult * av_sum[i] + onem_avb * (10.0 * mlog10(scale * cd[i] * t_pixels[i] + 1e-60)));
+				pixels[i] = (dOUTREAL)av_sum[i];
+			}
+			break;
+		}
+	}
+	if (norm)
+		for (i = 0; i < num_pixels; i++)
+			pixels[i] += (dOUTREAL)norm_oneHz;
+}
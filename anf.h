@@ -42,7 +42,7 @@ typedef struct _anf
 	int delay;
 	double two_mu;
 	double gamma;
-	double d [ANF_DLINE_SIZE];
+	double d [2 * ANF_DLINE_SIZE];		// mirrored:  d[k + dline_size] == d[k], so any n_taps window is contiguous
 	double w [ANF_DLINE_SIZE];
 	int in_idx;
 
@@ -68,7 +68,7 @@ ANR create_anr	(
 	a->lincr = lincr;
 	a->ldecr = ldecr;
 	
-	memset (a->d, 0, sizeof(double) * ANR_DLINE_SIZE);
+	memset (a->d, 0, sizeof(double) * 2 * ANR_DLINE_SIZE);
 	memset (a->w, 0, sizeof(double) * ANR_DLINE_SIZE);
 	
 	return a;
@@ -81,25 +81,28 @@ void destroy_anr (ANR a)
 
 void xanr (ANR a, int position)
 {
-    int i, j, idx;
-    double c0, c1;
+    int i, s;
+    double c0, c1, x;
     double y, error, sigma, inv_sigp;
 	double nel, nev;
+	double* p;
     if (a->run && (a->position == position))
 	{
+		// signal power in the tap window, then kept as a running sum as the window slides
+		s = (a->in_idx + 1 + a->delay) & a->mask;
+		sigma = rdot (a->d + s, a->d + s, a->n_taps);
 		for (i = 0; i < a->buff_size; i++)
 		{
-			a->d[a->in_idx] = a->in_buff[2 * i + 0];
-
-			y = 0;
-			sigma = 0;
-
-			for (j = 0; j < a->n_taps; j++)
-			{
-				idx = (a->in_idx + j + a->delay) & a->mask;
-				y += a->w[j] * a->d[idx];
-				sigma += a->d[idx] * a->d[idx];
-			}
+			s = (a->in_idx + a->delay) & a->mask;
+			p = a->d + s;
+			sigma += p[0] * p[0] - p[a->n_taps] * p[a->n_taps];
+			x = a->in_buff[2 * i + 0];
+			if (((a->in_idx - s) & a->mask) < a->n_taps)	// the new sample lands inside the window
+				sigma += x * x - a->d[a->in_idx] * a->d[a->in_idx];
+			a->d[a->in_idx] = a->d[a->in_idx + a->dline_size] = x;
+			if (sigma < 0.0) sigma = 0.0;
+
+			y = rdot (a->w, p, a->n_taps);
 			inv_sigp = 1.0 / (sigma + 1e-10);
 			error = a->d[a->in_idx] - y;
 
@@ -121,11 +124,7 @@ void xanr (ANR a, int position)
 			c0 = 1.0 - a->two_mu * a->ngamma;
 			c1 = a->two_mu * error * inv_sigp;
 
-			for (j = 0; j < a->n_taps; j++)
-			{
-				idx = (a->in_idx + j + a->delay) & a->mask;
-				a->w[j] = c0 * a->w[j] + c1 * a->d[idx];
-			}
+			raxpby (a->w, c0, c1, p, a->n_taps);
 			a->in_idx = (a->in_idx + a->mask) & a->mask;
 		}
 	}
@@ -135,7 +134,7 @@ void xanr (ANR a, int position)
 
 void flush_anr (ANR a)
 {
-	memset (a->d, 0, sizeof(double) * ANR_DLINE_SIZE);
+	memset (a->d, 0, sizeof(double) * 2 * ANR_DLINE_SIZE);
 	memset (a->w, 0, sizeof(double) * ANR_DLINE_SIZE);
 	a->in_idx = 0;
 }
@@ -240,6 +239,7 @@ SetRXAANRPosition (int channel, int position)
 	EnterCriticalSection (&ch[channel].csDSP);
 	rxa[channel].anr.p->position = position;
 	rxa[channel].bp1.p->position = position;
+	RXAeqbp1Set (channel);
 	flush_anr (rxa[channel].anr.p);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
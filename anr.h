@@ -42,7 +42,7 @@ typedef struct _anr
 	int delay;
 	double two_mu;
 	double gamma;
-	double d [ANR_DLINE_SIZE];
+	double d [2 * ANR_DLINE_SIZE];		// mirrored:  d[k + dline_size] == d[k], so any n_taps window is contiguous
 	double w [ANR_DLINE_SIZE];
 	int in_idx;
 
@@ -145,6 +145,7 @@ void SetRXABPSRun (int channel, int run)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
 	rxa[channel].bp1.p->run = run;
+	RXAeqbp1Set (channel);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
@@ -300,7 +301,7 @@ BANDPASS create_bandpass (int run, int position, int size, int nc, int mp, doubl
 	a->wintype = wintype;
 	a->gain = gain;
 	impulse = fir_bandpass (a->nc, a->f_low, a->f_high, a->samplerate, a->wintype, 1, a->gain / (double)(2 * a->size));
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, a->nup);
 	_aligned_free (impulse);
 	return a;
 }
@@ -386,6 +387,7 @@ void SetRXABandpassRun (int channel, int run)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
 	rxa[channel].bp1.p->run = run;
+	RXAeqbp1Set (channel);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
@@ -456,6 +458,20 @@ void SetRXABandpassMP (int channel, int mp)
 	}
 }
 
+PORT
+void SetRXABandpassNUP (int channel, int nup)
+{
+	BANDPASS a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = rxa[channel].bp1.p;
+	if (nup != a->nup)
+	{
+		a->nup = nup;
+		setNup_fircore (a->p, a->nup);
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 /********************************************************************************************************
 *																										*
 *											TXA Properties												*
@@ -591,4 +607,30 @@ void SetTXABandpassMP (int channel, int mp)
 		a->mp = mp;
 		setMp_fircore (a->p, a->mp);
 	}
-}
\ No newline at end of file
+}
+
+PORT
+void SetTXABandpassNUP (int channel, int nup)
+{
+	BANDPASS a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = txa[channel].bp0.p;
+	if (nup != a->nup)
+	{
+		a->nup = nup;
+		setNup_fircore (a->p, a->nup);
+	}
+	a = txa[channel].bp1.p;
+	if (nup != a->nup)
+	{
+		a->nup = nup;
+		setNup_fircore (a->p, a->nup);
+	}
+	a = txa[channel].bp2.p;
+	if (nup != a->nup)
+	{
+		a->nup = nup;
+		setNup_fircore (a->p, a->nup);
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
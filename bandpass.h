@@ -101,6 +101,7 @@ typedef struct _bandpass
 	int size;
 	int nc;
 	int mp;
+	int nup;
 	double* in;
 	double* out;
 	double f_low;
@@ -140,4 +141,8 @@ extern __declspec (dllexport) void SetTXABandpassNC (int channel, int nc);
 
 extern __declspec (dllexport) void SetTXABandpassMP (int channel, int mp);
 
+extern __declspec (dllexport) void SetRXABandpassNUP (int channel, int nup);
+
+extern __declspec (dllexport) void SetTXABandpassNUP (int channel, int nup);
+
 #endif
@@ -0,0 +1,332 @@
+/*  bench.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+// Throughput benchmark for the library, built by 'make bench'.  Each benchmark is run for every
+// combination of buffer size and sample rate given on the command line, and reports one JSON object
+// per line on stdout.
+//
+//		wdsp_bench [-s sizes] [-r rates] [-n blocks] [-c taps] [-b benches] [-w dir]
+//
+//		-s		comma-separated buffer sizes, in complex samples (default 1024)
+//		-r		comma-separated input sample rates (default 48000)
+//		-n		number of buffers processed per run (default 2000)
+//		-c		filter length for the fircore benchmark (default 4096)
+//		-b		comma-separated benchmarks:  rxa, txa, fircore, resample, emnr, anr, anb, nob (default all)
+//		-w		directory holding (or to receive) the FFTW wisdom file; without it, plans are estimated
+//
+// Channel benchmarks run through OpenChannel() and fexchange0(), so they include the exchange with the
+// dsp thread; with a library built with PROFILE=1 they also report the time spent in each stage.
+
+#include <stdio.h>
+#include "comm.h"
+
+extern int WDSPwisdom (char* directory);
+
+#define BENCH_MAX_LIST			16
+
+static int nblocks = 2000;
+static int ntaps = 4096;
+
+static double bench_now (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+}
+
+static int parse_list (char* arg, int* list)
+{
+	int n = 0;
+	char* tok = strtok (arg, ",");
+	while (tok && n < BENCH_MAX_LIST)
+	{
+		list[n++] = atoi (tok);
+		tok = strtok (0, ",");
+	}
+	return n;
+}
+
+static void synth (double* buff, int size, int rate, int block)
+{
+	// two tones, a little noise, and an impulse now and then for the blankers
+	int i;
+	double t;
+	for (i = 0; i < size; i++)
+	{
+		t = (double)(block * size + i) / (double)rate;
+		buff[2 * i + 0] = 0.1 * cos (TWOPI * 1000.0 * t) + 0.05 * cos (TWOPI * 1700.0 * t)
+			+ 1.0e-3 * ((double)rand () / RAND_MAX - 0.5);
+		buff[2 * i + 1] = 0.1 * sin (TWOPI * 1000.0 * t) + 0.05 * sin (TWOPI * 1700.0 * t)
+			+ 1.0e-3 * ((double)rand () / RAND_MAX - 0.5);
+	}
+	if (block % 8 == 0)
+		buff[2 * (size / 2)] = 5.0;
+}
+
+/********************************************************************************************************
+*																										*
+*											Reporting													*
+*																										*
+********************************************************************************************************/
+
+typedef struct _lat
+{
+	int count;
+	double sum;
+	double min;
+	double max;
+} lat;
+
+static void lat_add (lat* a, double t)
+{
+	if (a->count == 0 || t < a->min) a->min = t;
+	if (t > a->max) a->max = t;
+	a->sum += t;
+	a->count++;
+}
+
+static void report (const char* bench, const char* variant, int size, int in_rate, int out_rate, double samples, lat* a)
+{
+	printf ("{\"bench\":\"%s\",\"variant\":\"%s\",\"size\":%d,\"in_rate\":%d,\"out_rate\":%d,"
+		"\"blocks\":%d,\"seconds\":%.6f,\"samples_per_sec\":%.1f,\"realtime\":%.2f,"
+		"\"min_ns\":%.0f,\"mean_ns\":%.0f,\"max_ns\":%.0f}\n",
+		bench, variant, size, in_rate, out_rate, a->count, a->sum, samples / a->sum,
+		samples / a->sum / (double)in_rate, 1.0e9 * a->min, 1.0e9 * a->sum / a->count, 1.0e9 * a->max);
+	fflush (stdout);
+}
+
+static void report_stages (const char* bench, const char* variant, int channel, int size, int in_rate)
+{
+	int n, i;
+	char name[PROF_NAMELEN];
+	double stats[5];
+	n = GetChannelProfile (channel, -1, 0, 0);
+	for (i = 0; i < n; i++)
+	{
+		GetChannelProfile (channel, i, name, stats);
+		printf ("{\"bench\":\"%s.stage\",\"variant\":\"%s\",\"size\":%d,\"in_rate\":%d,\"stage\":\"%s\","
+			"\"calls\":%.0f,\"min_ns\":%.0f,\"mean_ns\":%.0f,\"p99_ns\":%.0f,\"max_ns\":%.0f}\n",
+			bench, variant, size, in_rate, name, stats[0], stats[1], stats[2], stats[3], stats[4]);
+	}
+	fflush (stdout);
+}
+
+/********************************************************************************************************
+*																										*
+*											Channel Benchmarks											*
+*																										*
+********************************************************************************************************/
+
+static void bench_channel (int type, int mode, const char* variant, int size, int rate)
+{
+	const int channel = 0;
+	const int dsp_rate = 48000;
+	int i, err;
+	double t;
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 (size * sizeof (complex));
+	lat a = { 0 };
+	OpenChannel (channel, size, size, rate, dsp_rate, dsp_rate, type, 0, 0.0, 0.0, 0.0, 0.0, 1);
+	if (type == 0)
+	{
+		SetRXAMode (channel, mode);
+		if (mode == RXA_AM) SetRXAEMNRRun (channel, 1);
+	}
+	else
+		SetTXAMode (channel, mode);
+	SetChannelState (channel, 1, 0);
+	for (i = 0; i < 16; i++)
+	{
+		synth (in, size, rate, i);
+		fexchange0 (channel, in, out, &err);
+	}
+	ResetChannelProfile (channel);
+	for (i = 0; i < nblocks; i++)
+	{
+		synth (in, size, rate, i);
+		t = bench_now ();
+		fexchange0 (channel, in, out, &err);
+		lat_add (&a, bench_now () - t);
+	}
+	report (type == 0 ? "rxa" : "txa", variant, size, rate, dsp_rate, (double)size * nblocks, &a);
+	report_stages (type == 0 ? "rxa" : "txa", variant, channel, size, rate);
+	CloseChannel (channel);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+/********************************************************************************************************
+*																										*
+*											Block Benchmarks											*
+*																										*
+********************************************************************************************************/
+
+#define BENCH_BLOCK(name, variant, size, in_rate, out_rate, call)			\
+	do																		\
+	{																		\
+		lat _a = { 0 };														\
+		double _t;															\
+		int _i;																\
+		for (_i = 0; _i < nblocks; _i++)									\
+		{																	\
+			synth (in, size, in_rate, _i);									\
+			_t = bench_now ();												\
+			call;															\
+			lat_add (&_a, bench_now () - _t);								\
+		}																	\
+		report (name, variant, size, in_rate, out_rate, (double)(size) * nblocks, &_a);	\
+	} while (0)
+
+static void bench_fircore (int size, int rate)
+{
+	int nup;
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 (2 * size * sizeof (complex));		// the inverse fft writes 2 * size
+	double* impulse = fir_bandpass (ntaps, 150.0, 2850.0, (double)rate, 0, 1, 1.0 / (double)(2 * size));
+	FIRCORE p;
+	for (nup = 0; nup <= 1; nup++)
+	{
+		p = create_fircore (size, in, out, ntaps, 0, impulse, nup);
+		BENCH_BLOCK ("fircore", nup ? "nonuniform" : "uniform", size, rate, rate, xfircore (p));
+		destroy_fircore (p);
+	}
+	_aligned_free (impulse);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+static void bench_resample (int size, int rate)
+{
+	int out_rate = rate == 48000 ? 8000 : 48000;
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 ((size * (out_rate / 1000) / (rate / 1000) + 1) * sizeof (complex));
+	RESAMPLE p = create_resample (1, size, in, out, rate, out_rate, 0.0, 0, 1.0);
+	BENCH_BLOCK ("resample", "", size, rate, out_rate, xresample (p));
+	destroy_resample (p);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+static void bench_emnr (int size, int rate)
+{
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 (size * sizeof (complex));
+	EMNR p = create_emnr (1, 0, size, in, out, 4096, 4, rate, 0, 1.0, 2, 0, 1);
+	BENCH_BLOCK ("emnr", "", size, rate, rate, xemnr (p, 0));
+	destroy_emnr (p);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+static void bench_anr (int size, int rate)
+{
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 (size * sizeof (complex));
+	ANR p = create_anr (1, 0, size, in, out, ANR_DLINE_SIZE, 64, 16, 0.0001, 0.1,
+		120.0, 120.0, 200.0, 0.001, 6.25e-10, 1.0, 3.0);
+	BENCH_BLOCK ("anr", "", size, rate, rate, xanr (p, 0));
+	destroy_anr (p);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+static void bench_anb (int size, int rate)
+{
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 (size * sizeof (complex));
+	ANB p = create_anb (1, size, in, out, (double)rate, 0.0001, 0.0001, 0.0001, 0.05, 30.0);
+	BENCH_BLOCK ("anb", "", size, rate, rate, xanb (p));
+	destroy_anb (p);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+static void bench_nob (int size, int rate)
+{
+	double* in  = (double *)malloc0 (size * sizeof (complex));
+	double* out = (double *)malloc0 (size * sizeof (complex));
+	NOB p = create_nob (1, size, in, out, (double)rate, 0, 0.0001, 0.0001, 0.0001, 0.0001, 0.025, 0.05, 30.0);
+	BENCH_BLOCK ("nob", "", size, rate, rate, xnob (p));
+	destroy_nob (p);
+	_aligned_free (out);
+	_aligned_free (in);
+}
+
+/********************************************************************************************************
+*																										*
+*											Driver														*
+*																										*
+********************************************************************************************************/
+
+static int selected (const char* benches, const char* name)
+{
+	char list[256];
+	char* tok;
+	if (!benches) return 1;
+	strncpy (list, benches, sizeof (list) - 1);
+	list[sizeof (list) - 1] = 0;
+	for (tok = strtok (list, ","); tok; tok = strtok (0, ","))
+		if (!strcmp (tok, name)) return 1;
+	return 0;
+}
+
+int main (int argc, char** argv)
+{
+	int sizes[BENCH_MAX_LIST] = { 1024 };
+	int rates[BENCH_MAX_LIST] = { 48000 };
+	int nsizes = 1, nrates = 1;
+	int i, j, k;
+	const char* benches = 0;
+	char* wisdom = 0;
+	for (k = 1; k + 1 < argc; k += 2)
+	{
+		if      (!strcmp (argv[k], "-s")) nsizes = parse_list (argv[k + 1], sizes);
+		else if (!strcmp (argv[k], "-r")) nrates = parse_list (argv[k + 1], rates);
+		else if (!strcmp (argv[k], "-n")) nblocks = atoi (argv[k + 1]);
+		else if (!strcmp (argv[k], "-c")) ntaps = atoi (argv[k + 1]);
+		else if (!strcmp (argv[k], "-b")) benches = argv[k + 1];
+		else if (!strcmp (argv[k], "-w")) wisdom = argv[k + 1];
+		else break;
+	}
+	if (k < argc || nsizes < 1 || nrates < 1 || nblocks < 1 || ntaps < 1)
+	{
+		fprintf (stderr, "usage:  %s [-s sizes] [-r rates] [-n blocks] [-c taps] [-b rxa,txa,fircore,resample,emnr,anr,anb,nob] [-w dir]\n", argv[0]);
+		return 1;
+	}
+	if (wisdom) WDSPwisdom (wisdom);
+	for (i = 0; i < nsizes; i++)
+		for (j = 0; j < nrates; j++)
+		{
+			if (selected (benches, "rxa"))
+			{
+				bench_channel (0, RXA_USB, "usb", sizes[i], rates[j]);
+				bench_channel (0, RXA_AM, "am+emnr", sizes[i], rates[j]);
+			}
+			if (selected (benches, "txa"))
+				bench_channel (1, TXA_USB, "usb", sizes[i], rates[j]);
+			if (selected (benches, "fircore"))  bench_fircore  (sizes[i], rates[j]);
+			if (selected (benches, "resample")) bench_resample (sizes[i], rates[j]);
+			if (selected (benches, "emnr"))     bench_emnr     (sizes[i], rates[j]);
+			if (selected (benches, "anr"))      bench_anr      (sizes[i], rates[j]);
+			if (selected (benches, "anb"))      bench_anb      (sizes[i], rates[j]);
+			if (selected (benches, "nob"))      bench_nob      (sizes[i], rates[j]);
+		}
+	return 0;
+}
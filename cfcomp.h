@@ -38,33 +38,17 @@ typedef struct _cfcomp
 	int ovrlp;
 	int incr;
 	double* window;
-	int iasize;
-	double* inaccum;
-	double* forfftin;
 	double* forfftout;
 	int msize;
 	double* cmask;
 	double* mask;
 	int mask_ready;
 	double* cfc_gain;
-	double* revfftin;
-	double* revfftout;
-	double** save;
-	int oasize;
-	double* outaccum;
 	double rate;
 	int wintype;
 	double pregain;
 	double postgain;
-	int nsamps;
-	int iainidx;
-	int iaoutidx;
-	int init_oainidx;
-	int oainidx;
-	int oaoutidx;
-	int saveidx;
-	fftw_plan Rfor;
-	fftw_plan Rrev;
+	STFT stft;
 
 	int comp_method;
 	int nfreqs;
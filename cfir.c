@@ -31,7 +31,7 @@ void calc_cfir (CFIR a)
 	double* impulse;
 	a->scale = 1.0 / (double)(2 * a->size);
 	impulse = cfir_impulse (a->nc, a->DD, a->R, a->Pairs, a->runrate, a->cicrate, a->cutoff, a->xtype, a->xbw, 1, a->scale, a->wintype);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, a->nup);
 	_aligned_free (impulse);
 }
 
@@ -252,3 +252,17 @@ void SetTXACFIRNC(int channel, int nc)
 	}
 	LeaveCriticalSection(&ch[channel].csDSP);
 }
+
+PORT
+void SetTXACFIRNUP(int channel, int nup)
+{
+	CFIR a;
+	EnterCriticalSection(&ch[channel].csDSP);
+	a = txa[channel].cfir.p;
+	if (a->nup != nup)
+	{
+		a->nup = nup;
+		setNup_fircore(a->p, a->nup);
+	}
+	LeaveCriticalSection(&ch[channel].csDSP);
+}
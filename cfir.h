@@ -33,6 +33,7 @@ typedef struct _cfir
 	int size;
 	int nc;
 	int mp;
+	int nup;
 	double* in;
 	double* out;
 	int runrate;
@@ -72,4 +73,6 @@ extern __declspec (dllexport) void SetTXACFIRRun(int channel, int run);
 
 extern __declspec (dllexport) void SetTXACFIRNC(int channel, int nc);
 
+extern __declspec (dllexport) void SetTXACFIRNUP(int channel, int nup);
+
 #endif
\ No newline at end of file
@@ -30,6 +30,9 @@ struct _ch ch[MAX_CHANNELS];
 
 void start_thread (int channel)
 {
+	ch[channel].exec_pending = 0;
+	if ((ch[channel].pooled = pooled_main ()))
+		return;
 	HANDLE handle = (HANDLE) _beginthread(wdspmain, 0, (void *)(uintptr_t)channel);
 	//SetThreadPriority(handle, THREAD_PRIORITY_HIGHEST);
 }
@@ -88,6 +91,7 @@ void OpenChannel (int channel, int in_size, int dsp_size, int input_samplerate,
 	ch[channel].tdelaydown = tdelaydown;
 	ch[channel].tslewdown = tslewdown;
 	ch[channel].bfo = bfo;
+	ch[channel].bp = 0;
 	InterlockedBitTestAndReset (&ch[channel].exchange, 0);
 	build_channel (channel);
 	if (ch[channel].state)
@@ -108,6 +112,11 @@ void pre_main_destroy (int channel)
 	InterlockedBitTestAndReset (&ch[channel].exchange, 0);
 	InterlockedBitTestAndReset (&ch[channel].run, 0);
 	InterlockedBitTestAndSet (&ch[channel].iob.pc->exec_bypass, 0);
+	if (ch[channel].pooled)
+	{
+		stop_main (channel);
+		return;
+	}
 	ReleaseSemaphore (a->Sem_BuffReady, 1, 0);
 	Sleep (25);
 }
@@ -345,3 +354,55 @@ void SetChannelTSlewDown (int channel, double time)
 	create_slews (a);
 	LeaveCriticalSection (&ch[channel].csEXCH);
 }
+
+/********************************************************************************************************
+*																										*
+*										   Exchange Accounting											*
+*																										*
+********************************************************************************************************/
+
+// Counts are in fexchange() calls, levels in complex samples.  The counts start over when the channel's
+// buffers are rebuilt (size and rate changes).
+
+PORT
+void SetChannelBackpressure (int channel, int bp)
+{
+	// bp = 1:  a fexchange() whose input would overwrite unprocessed input drops it and reports the overrun;
+	// the caller can use GetChannelInputSpace() to hold input back instead
+	EnterCriticalSection (&ch[channel].csEXCH);
+	ch[channel].bp = bp;
+	ch[channel].iob.pc->bp = bp;
+	LeaveCriticalSection (&ch[channel].csEXCH);
+}
+
+PORT
+int GetChannelInputSpace (int channel)
+{
+	// number of input samples the channel can accept now without an overrun
+	IOB a = ch[channel].iob.pc;
+	int space = a->r1_capacity - (int)ReadAcquire (&a->r1_havesamps);
+	return space > 0 ? space : 0;
+}
+
+PORT
+void GetChannelStats (int channel, int* overruns, int* underruns, int* r1_hwm, int* r2_hwm)
+{
+	IOB a = ch[channel].iob.pc;
+	*overruns  = (int)a->stats.overruns;
+	*underruns = (int)a->stats.underruns;
+	*r1_hwm    = (int)a->stats.r1_hwm;
+	*r2_hwm    = (int)a->stats.r2_hwm;
+}
+
+PORT
+void ResetChannelStats (int channel)
+{
+	IOB a;
+	EnterCriticalSection (&ch[channel].csEXCH);
+	a = ch[channel].iob.pc;
+	a->stats.overruns  = 0;
+	a->stats.underruns = 0;
+	a->stats.r1_hwm = ReadAcquire (&a->r1_havesamps);
+	a->stats.r2_hwm = 0;
+	LeaveCriticalSection (&ch[channel].csEXCH);
+}
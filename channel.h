@@ -49,7 +49,10 @@ struct _ch
 	double tdelaydown;
 	double tslewdown;
 	int bfo;					// 'block_for_output', block fexchange until output is available
+	int bp;						// 'backpressure', fexchange refuses input rather than overwrite unprocessed input
 	volatile long flushflag;
+	int pooled;					// 1 if run by the pooled executor rather than its own thread
+	volatile LONG exec_pending;	// pooled:  number of dsp buffers ready but not yet processed
 	struct	//io buffers
 	{
 		IOB pc, pd, pe, pf;		// copies for console calls, dsp, exchange, and flush thread
@@ -81,4 +84,12 @@ PORT void SetAllRates (int channel, int in_rate, int dsp_rate, int out_rate);
 
 PORT int SetChannelState (int channel, int state, int dmode);
 
+PORT void SetChannelBackpressure (int channel, int bp);
+
+PORT int GetChannelInputSpace (int channel);
+
+PORT void GetChannelStats (int channel, int* overruns, int* underruns, int* r1_hwm, int* r2_hwm);
+
+PORT void ResetChannelStats (int channel);
+
 #endif
@@ -0,0 +1,724 @@
+/*  cmac.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include "comm.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CMAC_X86
+#define CMAC_TARGET(t) __attribute__ ((target (t)))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CMAC_X86
+#define CMAC_TARGET(t)
+#endif
+
+#ifdef CMAC_X86
+#include <immintrin.h>
+#endif
+
+/********************************************************************************************************
+*																										*
+*											Scalar Kernels												*
+*																										*
+********************************************************************************************************/
+
+static void cmac_scalar (double* acc, double* a, double* b, int n)
+{
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		acc[2 * i + 0] += a[2 * i + 0] * b[2 * i + 0] - a[2 * i + 1] * b[2 * i + 1];
+		acc[2 * i + 1] += a[2 * i + 0] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i + 0];
+	}
+}
+
+static void cmul_scalar (double* out, double* a, double* b, int n)
+{
+	int i;
+	double I, Q;
+	for (i = 0; i < n; i++)
+	{
+		I = a[2 * i + 0] * b[2 * i + 0] - a[2 * i + 1] * b[2 * i + 1];
+		Q = a[2 * i + 0] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i + 0];
+		out[2 * i + 0] = I;
+		out[2 * i + 1] = Q;
+	}
+}
+
+static void cdotr_scalar (double* out, double* h, double* x, int n)
+{
+	int j;
+	double I = 0.0, Q = 0.0;
+	for (j = 0; j < n; j++)
+	{
+		I += h[j] * x[2 * j + 0];
+		Q += h[j] * x[2 * j + 1];
+	}
+	out[0] = I;
+	out[1] = Q;
+}
+
+static double rdot_scalar (double* h, double* x, int n)
+{
+	int j;
+	double I = 0.0;
+	for (j = 0; j < n; j++)
+		I += h[j] * x[j];
+	return I;
+}
+
+static float rdotf_scalar (float* h, float* x, int n)
+{
+	int j;
+	float I = 0.0f;
+	for (j = 0; j < n; j++)
+		I += h[j] * x[j];
+	return I;
+}
+
+static void raxpby_scalar (double* y, double a, double b, double* x, int n)
+{
+	int j;
+	for (j = 0; j < n; j++)
+		y[j] = a * y[j] + b * x[j];
+}
+
+static void cmag_scalar (double* mag, double* x, int n)
+{
+	int j;
+	for (j = 0; j < n; j++)
+		mag[j] = sqrt (x[2 * j + 0] * x[2 * j + 0] + x[2 * j + 1] * x[2 * j + 1]);
+}
+
+static void cvt16_scalar (double* out, short* in, double scale, int n)
+{
+	int j;
+	for (j = 0; j < 2 * n; j++)
+		out[j] = scale * (double)in[j];
+}
+
+static void cvt24_scalar (double* out, unsigned char* in, double scale, int n)
+{
+	int j;
+	int v;
+	for (j = 0; j < 2 * n; j++)
+	{
+		// assemble in the top three bytes, then sign-extend with an arithmetic shift
+		v = (int)((unsigned)in[3 * j + 0] << 8 | (unsigned)in[3 * j + 1] << 16 | (unsigned)in[3 * j + 2] << 24);
+		out[j] = scale * (double)(v >> 8);
+	}
+}
+
+#ifdef CMAC_X86
+
+/********************************************************************************************************
+*																										*
+*											SSE2 Kernels												*
+*																										*
+********************************************************************************************************/
+
+// one complex sample per vector; the real part of the product takes its sign from 'neg'
+
+CMAC_TARGET("sse2")
+static __m128d cprod_sse2 (__m128d va, __m128d vb, __m128d neg)
+{
+	__m128d re = _mm_unpacklo_pd (vb, vb);						// br br
+	__m128d im = _mm_unpackhi_pd (vb, vb);						// bi bi
+	__m128d sw = _mm_shuffle_pd (va, va, 1);					// ai ar
+	return _mm_add_pd (_mm_mul_pd (va, re), _mm_xor_pd (_mm_mul_pd (sw, im), neg));
+}
+
+CMAC_TARGET("sse2")
+static void cmac_sse2 (double* acc, double* a, double* b, int n)
+{
+	int i;
+	__m128d neg = _mm_set_pd (0.0, -0.0);
+	for (i = 0; i < n; i++)
+		_mm_storeu_pd (acc + 2 * i, _mm_add_pd (_mm_loadu_pd (acc + 2 * i),
+			cprod_sse2 (_mm_loadu_pd (a + 2 * i), _mm_loadu_pd (b + 2 * i), neg)));
+}
+
+CMAC_TARGET("sse2")
+static void cmul_sse2 (double* out, double* a, double* b, int n)
+{
+	int i;
+	__m128d neg = _mm_set_pd (0.0, -0.0);
+	for (i = 0; i < n; i++)
+		_mm_storeu_pd (out + 2 * i, cprod_sse2 (_mm_loadu_pd (a + 2 * i), _mm_loadu_pd (b + 2 * i), neg));
+}
+
+CMAC_TARGET("sse2")
+static void cdotr_sse2 (double* out, double* h, double* x, int n)
+{
+	int j;
+	__m128d acc0 = _mm_setzero_pd ();
+	__m128d acc1 = _mm_setzero_pd ();
+	for (j = 0; j + 2 <= n; j += 2)
+	{
+		acc0 = _mm_add_pd (acc0, _mm_mul_pd (_mm_set1_pd (h[j + 0]), _mm_loadu_pd (x + 2 * j + 0)));
+		acc1 = _mm_add_pd (acc1, _mm_mul_pd (_mm_set1_pd (h[j + 1]), _mm_loadu_pd (x + 2 * j + 2)));
+	}
+	if (j < n)
+		acc0 = _mm_add_pd (acc0, _mm_mul_pd (_mm_set1_pd (h[j]), _mm_loadu_pd (x + 2 * j)));
+	_mm_storeu_pd (out, _mm_add_pd (acc0, acc1));
+}
+
+CMAC_TARGET("sse2")
+static double rdot_sse2 (double* h, double* x, int n)
+{
+	int j;
+	double r[2];
+	__m128d acc = _mm_setzero_pd ();
+	for (j = 0; j + 2 <= n; j += 2)
+		acc = _mm_add_pd (acc, _mm_mul_pd (_mm_loadu_pd (h + j), _mm_loadu_pd (x + j)));
+	_mm_storeu_pd (r, acc);
+	return r[0] + r[1] + rdot_scalar (h + j, x + j, n - j);
+}
+
+CMAC_TARGET("sse2")
+static float rdotf_sse2 (float* h, float* x, int n)
+{
+	int j;
+	float r[4];
+	__m128 acc = _mm_setzero_ps ();
+	for (j = 0; j + 4 <= n; j += 4)
+		acc = _mm_add_ps (acc, _mm_mul_ps (_mm_loadu_ps (h + j), _mm_loadu_ps (x + j)));
+	_mm_storeu_ps (r, acc);
+	return (r[0] + r[1]) + (r[2] + r[3]) + rdotf_scalar (h + j, x + j, n - j);
+}
+
+CMAC_TARGET("sse2")
+static void raxpby_sse2 (double* y, double a, double b, double* x, int n)
+{
+	int j;
+	__m128d va = _mm_set1_pd (a);
+	__m128d vb = _mm_set1_pd (b);
+	for (j = 0; j + 2 <= n; j += 2)
+		_mm_storeu_pd (y + j, _mm_add_pd (_mm_mul_pd (va, _mm_loadu_pd (y + j)), _mm_mul_pd (vb, _mm_loadu_pd (x + j))));
+	raxpby_scalar (y + j, a, b, x + j, n - j);
+}
+
+CMAC_TARGET("sse2")
+static void cmag_sse2 (double* mag, double* x, int n)
+{
+	int j;
+	__m128d a, b;
+	for (j = 0; j + 2 <= n; j += 2)
+	{
+		a = _mm_loadu_pd (x + 2 * j + 0);
+		b = _mm_loadu_pd (x + 2 * j + 2);
+		a = _mm_mul_pd (a, a);
+		b = _mm_mul_pd (b, b);
+		_mm_storeu_pd (mag + j, _mm_sqrt_pd (_mm_add_pd (_mm_unpacklo_pd (a, b), _mm_unpackhi_pd (a, b))));
+	}
+	cmag_scalar (mag + j, x + 2 * j, n - j);
+}
+
+CMAC_TARGET("sse2")
+static void cvt16_sse2 (double* out, short* in, double scale, int n)
+{
+	int j;
+	__m128i v, lo, hi;
+	__m128d vs = _mm_set1_pd (scale);
+	for (j = 0; j + 4 <= n; j += 4)
+	{
+		v = _mm_loadu_si128 ((__m128i *)(in + 2 * j));
+		lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16);		// sign-extended values 0 - 3
+		hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (v, v), 16);		// sign-extended values 4 - 7
+		_mm_storeu_pd (out + 2 * j + 0, _mm_mul_pd (vs, _mm_cvtepi32_pd (lo)));
+		_mm_storeu_pd (out + 2 * j + 2, _mm_mul_pd (vs, _mm_cvtepi32_pd (_mm_shuffle_epi32 (lo, 0x0e))));
+		_mm_storeu_pd (out + 2 * j + 4, _mm_mul_pd (vs, _mm_cvtepi32_pd (hi)));
+		_mm_storeu_pd (out + 2 * j + 6, _mm_mul_pd (vs, _mm_cvtepi32_pd (_mm_shuffle_epi32 (hi, 0x0e))));
+	}
+	cvt16_scalar (out + 2 * j, in + 2 * j, scale, n - j);
+}
+
+/********************************************************************************************************
+*																										*
+*											AVX2 Kernels												*
+*																										*
+********************************************************************************************************/
+
+// two complex samples per vector; fmaddsub subtracts in the real lanes and adds in the imaginary lanes
+
+CMAC_TARGET("avx2,fma")
+static __m256d cprod_avx2 (__m256d va, __m256d vb)
+{
+	__m256d re = _mm256_movedup_pd (vb);						// br br
+	__m256d im = _mm256_permute_pd (vb, 0xf);					// bi bi
+	__m256d sw = _mm256_permute_pd (va, 0x5);					// ai ar
+	return _mm256_fmaddsub_pd (va, re, _mm256_mul_pd (sw, im));
+}
+
+CMAC_TARGET("avx2,fma")
+static void cmac_avx2 (double* acc, double* a, double* b, int n)
+{
+	int i;
+	for (i = 0; i + 2 <= n; i += 2)
+		_mm256_storeu_pd (acc + 2 * i, _mm256_add_pd (_mm256_loadu_pd (acc + 2 * i),
+			cprod_avx2 (_mm256_loadu_pd (a + 2 * i), _mm256_loadu_pd (b + 2 * i))));
+	cmac_scalar (acc + 2 * i, a + 2 * i, b + 2 * i, n - i);
+}
+
+CMAC_TARGET("avx2,fma")
+static void cmul_avx2 (double* out, double* a, double* b, int n)
+{
+	int i;
+	for (i = 0; i + 2 <= n; i += 2)
+		_mm256_storeu_pd (out + 2 * i, cprod_avx2 (_mm256_loadu_pd (a + 2 * i), _mm256_loadu_pd (b + 2 * i)));
+	cmul_scalar (out + 2 * i, a + 2 * i, b + 2 * i, n - i);
+}
+
+// two taps per vector:  the coefficients are spread as h0 h0 h1 h1 over the complex samples
+
+CMAC_TARGET("avx2,fma")
+static void cdotr_avx2 (double* out, double* h, double* x, int n)
+{
+	int j;
+	double r[4];
+	__m256d acc0 = _mm256_setzero_pd ();
+	__m256d acc1 = _mm256_setzero_pd ();
+	for (j = 0; j + 4 <= n; j += 4)
+	{
+		acc0 = _mm256_fmadd_pd (_mm256_permute4x64_pd (_mm256_castpd128_pd256 (_mm_loadu_pd (h + j + 0)), 0x50),
+			_mm256_loadu_pd (x + 2 * j + 0), acc0);
+		acc1 = _mm256_fmadd_pd (_mm256_permute4x64_pd (_mm256_castpd128_pd256 (_mm_loadu_pd (h + j + 2)), 0x50),
+			_mm256_loadu_pd (x + 2 * j + 4), acc1);
+	}
+	_mm256_storeu_pd (r, _mm256_add_pd (acc0, acc1));
+	cdotr_scalar (out, h + j, x + 2 * j, n - j);
+	out[0] += r[0] + r[2];
+	out[1] += r[1] + r[3];
+}
+
+CMAC_TARGET("avx2,fma")
+static double rdot_avx2 (double* h, double* x, int n)
+{
+	int j;
+	double r[4];
+	__m256d acc0 = _mm256_setzero_pd ();
+	__m256d acc1 = _mm256_setzero_pd ();
+	for (j = 0; j + 8 <= n; j += 8)
+	{
+		acc0 = _mm256_fmadd_pd (_mm256_loadu_pd (h + j + 0), _mm256_loadu_pd (x + j + 0), acc0);
+		acc1 = _mm256_fmadd_pd (_mm256_loadu_pd (h + j + 4), _mm256_loadu_pd (x + j + 4), acc1);
+	}
+	_mm256_storeu_pd (r, _mm256_add_pd (acc0, acc1));
+	return (r[0] + r[1]) + (r[2] + r[3]) + rdot_scalar (h + j, x + j, n - j);
+}
+
+CMAC_TARGET("avx2,fma")
+static float rdotf_avx2 (float* h, float* x, int n)
+{
+	int j;
+	__m128 r;
+	__m256 acc0 = _mm256_setzero_ps ();
+	__m256 acc1 = _mm256_setzero_ps ();
+	for (j = 0; j + 16 <= n; j += 16)
+	{
+		acc0 = _mm256_fmadd_ps (_mm256_loadu_ps (h + j + 0), _mm256_loadu_ps (x + j + 0), acc0);
+		acc1 = _mm256_fmadd_ps (_mm256_loadu_ps (h + j + 8), _mm256_loadu_ps (x + j + 8), acc1);
+	}
+	acc0 = _mm256_add_ps (acc0, acc1);
+	r = _mm_add_ps (_mm256_castps256_ps128 (acc0), _mm256_extractf128_ps (acc0, 1));
+	r = _mm_add_ps (r, _mm_movehl_ps (r, r));
+	r = _mm_add_ss (r, _mm_shuffle_ps (r, r, 1));
+	return _mm_cvtss_f32 (r) + rdotf_scalar (h + j, x + j, n - j);
+}
+
+CMAC_TARGET("avx2,fma")
+static void raxpby_avx2 (double* y, double a, double b, double* x, int n)
+{
+	int j;
+	__m256d va = _mm256_set1_pd (a);
+	__m256d vb = _mm256_set1_pd (b);
+	for (j = 0; j + 4 <= n; j += 4)
+		_mm256_storeu_pd (y + j, _mm256_fmadd_pd (va, _mm256_loadu_pd (y + j), _mm256_mul_pd (vb, _mm256_loadu_pd (x + j))));
+	raxpby_scalar (y + j, a, b, x + j, n - j);
+}
+
+CMAC_TARGET("avx2,fma")
+static void cmag_avx2 (double* mag, double* x, int n)
+{
+	int j;
+	__m256d a, b;
+	for (j = 0; j + 4 <= n; j += 4)
+	{
+		a = _mm256_loadu_pd (x + 2 * j + 0);							// r0 i0 r1 i1
+		b = _mm256_loadu_pd (x + 2 * j + 4);							// r2 i2 r3 i3
+		a = _mm256_mul_pd (a, a);
+		b = _mm256_mul_pd (b, b);
+		a = _mm256_hadd_pd (a, b);										// m0 m2 m1 m3
+		_mm256_storeu_pd (mag + j, _mm256_sqrt_pd (_mm256_permute4x64_pd (a, 0xd8)));
+	}
+	cmag_scalar (mag + j, x + 2 * j, n - j);
+}
+
+CMAC_TARGET("avx2,fma")
+static void cvt16_avx2 (double* out, short* in, double scale, int n)
+{
+	int j;
+	__m256i v;
+	__m256d vs = _mm256_set1_pd (scale);
+	for (j = 0; j + 4 <= n; j += 4)
+	{
+		v = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((__m128i *)(in + 2 * j)));
+		_mm256_storeu_pd (out + 2 * j + 0, _mm256_mul_pd (vs, _mm256_cvtepi32_pd (_mm256_castsi256_si128 (v))));
+		_mm256_storeu_pd (out + 2 * j + 4, _mm256_mul_pd (vs, _mm256_cvtepi32_pd (_mm256_extracti128_si256 (v, 1))));
+	}
+	cvt16_scalar (out + 2 * j, in + 2 * j, scale, n - j);
+}
+
+// Eight values per pass:  each 128-bit lane holds four packed values in its low 12 bytes, which the byte
+// shuffle moves into the top three bytes of the 32-bit elements.  The upper lane is loaded from byte 12,
+// so a pass reads 4 bytes past its 24; the last passes are left to the scalar loop.
+
+CMAC_TARGET("avx2,fma")
+static void cvt24_avx2 (double* out, unsigned char* in, double scale, int n)
+{
+	int j;
+	__m256i v;
+	__m256d vs = _mm256_set1_pd (scale);
+	__m256i sh = _mm256_setr_epi8 (
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	for (j = 0; j + 5 <= n; j += 4)
+	{
+		v = _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((__m128i *)(in + 6 * j))),
+			_mm_loadu_si128 ((__m128i *)(in + 6 * j + 12)), 1);
+		v = _mm256_srai_epi32 (_mm256_shuffle_epi8 (v, sh), 8);
+		_mm256_storeu_pd (out + 2 * j + 0, _mm256_mul_pd (vs, _mm256_cvtepi32_pd (_mm256_castsi256_si128 (v))));
+		_mm256_storeu_pd (out + 2 * j + 4, _mm256_mul_pd (vs, _mm256_cvtepi32_pd (_mm256_extracti128_si256 (v, 1))));
+	}
+	cvt24_scalar (out + 2 * j, in + 6 * j, scale, n - j);
+}
+
+/********************************************************************************************************
+*																										*
+*											AVX-512 Kernels												*
+*																										*
+********************************************************************************************************/
+
+CMAC_TARGET("avx512f")
+static __m512d cprod_avx512 (__m512d va, __m512d vb)
+{
+	__m512d re = _mm512_movedup_pd (vb);
+	__m512d im = _mm512_permute_pd (vb, 0xff);
+	__m512d sw = _mm512_permute_pd (va, 0x55);
+	return _mm512_fmaddsub_pd (va, re, _mm512_mul_pd (sw, im));
+}
+
+CMAC_TARGET("avx512f")
+static void cmac_avx512 (double* acc, double* a, double* b, int n)
+{
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+		_mm512_storeu_pd (acc + 2 * i, _mm512_add_pd (_mm512_loadu_pd (acc + 2 * i),
+			cprod_avx512 (_mm512_loadu_pd (a + 2 * i), _mm512_loadu_pd (b + 2 * i))));
+	cmac_scalar (acc + 2 * i, a + 2 * i, b + 2 * i, n - i);
+}
+
+CMAC_TARGET("avx512f")
+static void cmul_avx512 (double* out, double* a, double* b, int n)
+{
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+		_mm512_storeu_pd (out + 2 * i, cprod_avx512 (_mm512_loadu_pd (a + 2 * i), _mm512_loadu_pd (b + 2 * i)));
+	cmul_scalar (out + 2 * i, a + 2 * i, b + 2 * i, n - i);
+}
+
+CMAC_TARGET("avx512f")
+static void cdotr_avx512 (double* out, double* h, double* x, int n)
+{
+	int j;
+	double r[8];
+	__m512i spread = _mm512_set_epi64 (3, 3, 2, 2, 1, 1, 0, 0);
+	__m512d acc0 = _mm512_setzero_pd ();
+	__m512d acc1 = _mm512_setzero_pd ();
+	for (j = 0; j + 8 <= n; j += 8)
+	{
+		acc0 = _mm512_fmadd_pd (_mm512_permutexvar_pd (spread, _mm512_castpd256_pd512 (_mm256_loadu_pd (h + j + 0))),
+			_mm512_loadu_pd (x + 2 * j + 0), acc0);
+		acc1 = _mm512_fmadd_pd (_mm512_permutexvar_pd (spread, _mm512_castpd256_pd512 (_mm256_loadu_pd (h + j + 4))),
+			_mm512_loadu_pd (x + 2 * j + 8), acc1);
+	}
+	_mm512_storeu_pd (r, _mm512_add_pd (acc0, acc1));
+	cdotr_scalar (out, h + j, x + 2 * j, n - j);
+	out[0] += (r[0] + r[2]) + (r[4] + r[6]);
+	out[1] += (r[1] + r[3]) + (r[5] + r[7]);
+}
+
+CMAC_TARGET("avx512f")
+static double rdot_avx512 (double* h, double* x, int n)
+{
+	int j;
+	__m512d acc0 = _mm512_setzero_pd ();
+	__m512d acc1 = _mm512_setzero_pd ();
+	for (j = 0; j + 16 <= n; j += 16)
+	{
+		acc0 = _mm512_fmadd_pd (_mm512_loadu_pd (h + j + 0), _mm512_loadu_pd (x + j + 0), acc0);
+		acc1 = _mm512_fmadd_pd (_mm512_loadu_pd (h + j + 8), _mm512_loadu_pd (x + j + 8), acc1);
+	}
+	return _mm512_reduce_add_pd (_mm512_add_pd (acc0, acc1)) + rdot_scalar (h + j, x + j, n - j);
+}
+
+CMAC_TARGET("avx512f")
+static float rdotf_avx512 (float* h, float* x, int n)
+{
+	int j;
+	__m512 acc0 = _mm512_setzero_ps ();
+	__m512 acc1 = _mm512_setzero_ps ();
+	for (j = 0; j + 32 <= n; j += 32)
+	{
+		acc0 = _mm512_fmadd_ps (_mm512_loadu_ps (h + j +  0), _mm512_loadu_ps (x + j +  0), acc0);
+		acc1 = _mm512_fmadd_ps (_mm512_loadu_ps (h + j + 16), _mm512_loadu_ps (x + j + 16), acc1);
+	}
+	return _mm512_reduce_add_ps (_mm512_add_ps (acc0, acc1)) + rdotf_scalar (h + j, x + j, n - j);
+}
+
+CMAC_TARGET("avx512f")
+static void raxpby_avx512 (double* y, double a, double b, double* x, int n)
+{
+	int j;
+	__m512d va = _mm512_set1_pd (a);
+	__m512d vb = _mm512_set1_pd (b);
+	for (j = 0; j + 8 <= n; j += 8)
+		_mm512_storeu_pd (y + j, _mm512_fmadd_pd (va, _mm512_loadu_pd (y + j), _mm512_mul_pd (vb, _mm512_loadu_pd (x + j))));
+	raxpby_scalar (y + j, a, b, x + j, n - j);
+}
+
+CMAC_TARGET("avx512f")
+static void cmag_avx512 (double* mag, double* x, int n)
+{
+	int j;
+	__m512d a, b;
+	__m512i lo = _mm512_set_epi64 (14, 12, 10, 8, 6, 4, 2, 0);
+	__m512i hi = _mm512_set_epi64 (15, 13, 11, 9, 7, 5, 3, 1);
+	for (j = 0; j + 8 <= n; j += 8)
+	{
+		a = _mm512_loadu_pd (x + 2 * j + 0);
+		b = _mm512_loadu_pd (x + 2 * j + 8);
+		a = _mm512_mul_pd (a, a);
+		b = _mm512_mul_pd (b, b);
+		_mm512_storeu_pd (mag + j, _mm512_sqrt_pd (_mm512_add_pd (_mm512_permutex2var_pd (a, lo, b), _mm512_permutex2var_pd (a, hi, b))));
+	}
+	cmag_scalar (mag + j, x + 2 * j, n - j);
+}
+
+CMAC_TARGET("avx512f")
+static void cvt16_avx512 (double* out, short* in, double scale, int n)
+{
+	int j;
+	__m512i v;
+	__m512d vs = _mm512_set1_pd (scale);
+	for (j = 0; j + 8 <= n; j += 8)
+	{
+		v = _mm512_cvtepi16_epi32 (_mm256_loadu_si256 ((__m256i *)(in + 2 * j)));
+		_mm512_storeu_pd (out + 2 * j + 0, _mm512_mul_pd (vs, _mm512_cvtepi32_pd (_mm512_castsi512_si256 (v))));
+		_mm512_storeu_pd (out + 2 * j + 8, _mm512_mul_pd (vs, _mm512_cvtepi32_pd (_mm512_extracti64x4_epi64 (v, 1))));
+	}
+	cvt16_scalar (out + 2 * j, in + 2 * j, scale, n - j);
+}
+
+#endif
+
+/********************************************************************************************************
+*																										*
+*											Dispatch													*
+*																										*
+********************************************************************************************************/
+
+static int cmac_level = -1;
+
+static int cmac_cpu_level (void)
+{
+#if defined(CMAC_X86) && defined(__GNUC__)
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx512f"))
+		return CMAC_AVX512;
+	if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+		return CMAC_AVX2;
+	if (__builtin_cpu_supports ("sse2"))
+		return CMAC_SSE2;
+	return CMAC_SCALAR;
+#elif defined(CMAC_X86)
+	int info[4];
+	unsigned long long xcr0;
+	__cpuid (info, 1);
+	if (!(info[3] & (1 << 26)))									// sse2
+		return CMAC_SCALAR;
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || !(info[2] & (1 << 12)))
+		return CMAC_SSE2;										// no osxsave, avx, or fma
+	xcr0 = _xgetbv (0);
+	if ((xcr0 & 0x06) != 0x06)									// os doesn't save ymm state
+		return CMAC_SSE2;
+	__cpuidex (info, 7, 0);
+	if ((info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)		// avx512f and zmm state
+		return CMAC_AVX512;
+	if (info[1] & (1 << 5))										// avx2
+		return CMAC_AVX2;
+	return CMAC_SSE2;
+#else
+	return CMAC_SCALAR;
+#endif
+}
+
+static void cmac_select (int level);
+
+static void cmac_resolve (double* acc, double* a, double* b, int n)
+{
+	cmac_select (-1);
+	cmac (acc, a, b, n);
+}
+
+static void cmul_resolve (double* out, double* a, double* b, int n)
+{
+	cmac_select (-1);
+	cmul (out, a, b, n);
+}
+
+static void cdotr_resolve (double* out, double* h, double* x, int n)
+{
+	cmac_select (-1);
+	cdotr (out, h, x, n);
+}
+
+static double rdot_resolve (double* h, double* x, int n)
+{
+	cmac_select (-1);
+	return rdot (h, x, n);
+}
+
+static float rdotf_resolve (float* h, float* x, int n)
+{
+	cmac_select (-1);
+	return rdotf (h, x, n);
+}
+
+static void raxpby_resolve (double* y, double a, double b, double* x, int n)
+{
+	cmac_select (-1);
+	raxpby (y, a, b, x, n);
+}
+
+static void cmag_resolve (double* mag, double* x, int n)
+{
+	cmac_select (-1);
+	cmag (mag, x, n);
+}
+
+static void cvt16_resolve (double* out, short* in, double scale, int n)
+{
+	cmac_select (-1);
+	cvt16 (out, in, scale, n);
+}
+
+static void cvt24_resolve (double* out, unsigned char* in, double scale, int n)
+{
+	cmac_select (-1);
+	cvt24 (out, in, scale, n);
+}
+
+void (*cmac) (double* acc, double* a, double* b, int n) = cmac_resolve;
+void (*cmul) (double* out, double* a, double* b, int n) = cmul_resolve;
+void (*cdotr) (double* out, double* h, double* x, int n) = cdotr_resolve;
+double (*rdot) (double* h, double* x, int n) = rdot_resolve;
+float (*rdotf) (float* h, float* x, int n) = rdotf_resolve;
+void (*raxpby) (double* y, double a, double b, double* x, int n) = raxpby_resolve;
+void (*cmag) (double* mag, double* x, int n) = cmag_resolve;
+void (*cvt16) (double* out, short* in, double scale, int n) = cvt16_resolve;
+void (*cvt24) (double* out, unsigned char* in, double scale, int n) = cvt24_resolve;
+
+static void cmac_select (int level)
+{
+	// level < 0 selects the best the cpu supports; otherwise it's limited to what the cpu supports
+	int max = cmac_cpu_level ();
+	if (level < 0 || level > max) level = max;
+	switch (level)
+	{
+#ifdef CMAC_X86
+	case CMAC_AVX512:
+		cmul = cmul_avx512;
+		cmac = cmac_avx512;
+		cdotr = cdotr_avx512;
+		rdot = rdot_avx512;
+		rdotf = rdotf_avx512;
+		raxpby = raxpby_avx512;
+		cmag = cmag_avx512;
+		cvt16 = cvt16_avx512;
+		cvt24 = cvt24_avx2;
+		break;
+	case CMAC_AVX2:
+		cmul = cmul_avx2;
+		cmac = cmac_avx2;
+		cdotr = cdotr_avx2;
+		rdot = rdot_avx2;
+		rdotf = rdotf_avx2;
+		raxpby = raxpby_avx2;
+		cmag = cmag_avx2;
+		cvt16 = cvt16_avx2;
+		cvt24 = cvt24_avx2;
+		break;
+	case CMAC_SSE2:
+		cmul = cmul_sse2;
+		cmac = cmac_sse2;
+		cdotr = cdotr_sse2;
+		rdot = rdot_sse2;
+		rdotf = rdotf_sse2;
+		raxpby = raxpby_sse2;
+		cmag = cmag_sse2;
+		cvt16 = cvt16_sse2;
+		cvt24 = cvt24_scalar;									// no byte shuffle before ssse3
+		break;
+#endif
+	default:
+		level = CMAC_SCALAR;
+		cmul = cmul_scalar;
+		cmac = cmac_scalar;
+		cdotr = cdotr_scalar;
+		rdot = rdot_scalar;
+		rdotf = rdotf_scalar;
+		raxpby = raxpby_scalar;
+		cmag = cmag_scalar;
+		cvt16 = cvt16_scalar;
+		cvt24 = cvt24_scalar;
+		break;
+	}
+	cmac_level = level;
+}
+
+/********************************************************************************************************
+*																										*
+*											Properties													*
+*																										*
+********************************************************************************************************/
+
+PORT
+void SetCMACLevel (int level)
+{
+	// -1 for automatic; otherwise CMAC_SCALAR ... CMAC_AVX512, limited to what the cpu supports
+	cmac_select (level);
+}
+
+PORT
+int GetCMACLevel (void)
+{
+	if (cmac_level < 0) cmac_select (-1);
+	return cmac_level;
+}
@@ -0,0 +1,64 @@
+/*  cmac.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef _cmac_h
+#define _cmac_h
+
+#define CMAC_SCALAR			0
+#define CMAC_SSE2			1
+#define CMAC_AVX2			2
+#define CMAC_AVX512			3
+
+// Complex vector kernels on interleaved (re, im) doubles; 'n' is the number of complex samples.
+// The implementation is chosen at first use from the instruction sets the cpu supports.
+//		cmac:  acc[i] += a[i] * b[i]
+//		cmul:  out[i]  = a[i] * b[i]
+extern void (*cmac) (double* acc, double* a, double* b, int n);
+
+extern void (*cmul) (double* out, double* a, double* b, int n);
+
+// Dot products with real coefficients 'h' over 'n' taps, for the polyphase resamplers.
+//		cdotr:  out[0] = sum h[j] * x[2j],  out[1] = sum h[j] * x[2j + 1]	(complex 'x')
+//		rdot:   returns sum h[j] * x[j]										(real 'x')
+//		rdotf:  as rdot, in single precision
+extern void (*cdotr) (double* out, double* h, double* x, int n);
+
+extern double (*rdot) (double* h, double* x, int n);
+
+extern float (*rdotf) (float* h, float* x, int n);
+
+// Real vector update for the adaptive filters:  y[j] = a * y[j] + b * x[j]
+extern void (*raxpby) (double* y, double a, double b, double* x, int n);
+
+// Magnitudes of 'n' complex samples:  mag[j] = |x[j]|
+extern void (*cmag) (double* mag, double* x, int n);
+
+// Integer I/Q to double for the exchange, 'n' complex samples:  out[j] = scale * in[j]
+//		cvt16:  16-bit values
+//		cvt24:  packed 24-bit little-endian values, 3 bytes each
+extern void (*cvt16) (double* out, short* in, double scale, int n);
+
+extern void (*cvt24) (double* out, unsigned char* in, double scale, int n);
+
+extern __declspec (dllexport) void SetCMACLevel (int level);
+
+extern __declspec (dllexport) int GetCMACLevel (void);
+
+#endif
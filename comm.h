@@ -44,6 +44,7 @@ warren@wpratt.com
 #include <avrt.h>
 #endif
 #include "fftw3.h"
+#include "stft.h"
 
 #include "amd.h"
 #include "ammod.h"
@@ -57,6 +58,8 @@ warren@wpratt.com
 #include "cfcomp.h"
 #include "cfir.h"
 #include "channel.h"
+#include "cmac.h"
+#include "nco.h"
 #include "compress.h"
 #include "delay.h"
 #include "dexp.h"
@@ -89,6 +92,7 @@ warren@wpratt.com
 #include "nobII.h"
 #include "osctrl.h"
 #include "patchpanel.h"
+#include "profile.h"
 #include "resample.h"
 #include "rmatch.h"
 #include "RXA.h"
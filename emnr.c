@@ -158,6 +158,68 @@ double e1xb (double x)
     return e1;
 }
 
+// GAIN FUNCTION TABLES
+// The MMSE amplitude (methods 0 and 3) and log-spectral amplitude (method 1) gains depend on the
+// a-posteriori and a-priori SNRs only through v = xi / (1 + xi) * gamma, which is below gamma_max:
+//		MMSE:  gain = F(sqrt(v)) / gamma,  F(u) = gf1p5 * u * exp(-v/2) * ((1 + v) * I0(v/2) + v * I1(v/2))
+//		LSA:   gain = ehr * K(sqrt(v)) / sqrt(v),  K(u) = u * exp(E1(v) / 2)
+// Both F and K are smooth in u = sqrt(v) (the sqrt(v) and 1/sqrt(v) behaviour at small v is factored
+// out), so they are tabulated with their derivatives once per process on a uniform grid in u and
+// evaluated by cubic Hermite interpolation, to within 5e-9 (relative) of the series above.  This
+// replaces the exp, sqrt, bessI0, bessI1 and e1xb calls per bin per frame with a sqrt and a look-up.
+
+#define EMNR_TAB			1024			// table intervals over 0 <= v < EMNR_VMAX
+#define EMNR_VMAX			40.0			// equal to g.gamma_max
+
+static double emnr_mmse_tab[2 * (EMNR_TAB + 2)];	// F(u), h * F'(u)
+static double emnr_lsa_tab [2 * (EMNR_TAB + 2)];	// K(u), h * K'(u)
+static double emnr_tab_scale;						// 1 / h
+static volatile LONG emnr_tab_ready;
+
+static double emnr_mmse (double u)
+{
+	double v = u * u;
+	return sqrt (PI) / 2.0 * u * exp (-0.5 * v) * ((1.0 + v) * bessI0 (0.5 * v) + v * bessI1 (0.5 * v));
+}
+
+static double emnr_lsa (double u)
+{
+	if (u == 0.0)
+		return exp (-0.5 * 0.5772156649015328);
+	return u * exp (0.5 * e1xb (u * u));
+}
+
+static void emnr_tab_init (void)
+{
+	int i;
+	double u, h, d;
+	h = sqrt (EMNR_VMAX) / (double)EMNR_TAB;
+	d = 1.0e-4 * h;
+	for (i = 0; i <= EMNR_TAB + 1; i++)
+	{
+		u = (double)i * h;
+		emnr_mmse_tab[2 * i + 0] = emnr_mmse (u);
+		emnr_mmse_tab[2 * i + 1] = h * (emnr_mmse (u + d) - emnr_mmse (u - d)) / (2.0 * d);
+		emnr_lsa_tab[2 * i + 0] = emnr_lsa (u);
+		if (i == 0)
+			emnr_lsa_tab[2 * i + 1] = 0.0;
+		else
+			emnr_lsa_tab[2 * i + 1] = h * (emnr_lsa (u + d) - emnr_lsa (u - d)) / (2.0 * d);
+	}
+	emnr_tab_scale = 1.0 / h;
+	WriteRelease (&emnr_tab_ready, 1);
+}
+
+static double emnr_interp (const double* tab, double u)
+{
+	double t = u * emnr_tab_scale;
+	int i = (int)t;
+	double f = t - (double)i;
+	double g = 1.0 - f;
+	const double* p = tab + 2 * i;
+	return ((1.0 + 2.0 * f) * p[0] + f * p[1]) * g * g + ((3.0 - 2.0 * f) * p[2] - g * p[3]) * f * f;
+}
+
 /********************************************************************************************************
 *																										*
 *											Main Body of Code											*
@@ -203,14 +265,18 @@ void interpM (double* res, double x, int nvals, double* xvals, double* yvals)
     }
 }
 
+// Reads a zetaHat table written by the training code; returns 0 if the file is present and its header
+// is consistent (a square table of at most 1024 x 1024 cells over non-empty ranges), else -1.
 int readZetaHat(const char* zeta_file, int* rows, int* cols,
-        double* gmin, double* gmax, double* ximin, double* ximax, double* zetaHat, int* zetaValid)
+        double* gmin, double* gmax, double* ximin, double* ximax, double** zetaHat, int** zetaValid)
 {
         char zetaBinary[256];
         char bin[50] = ".bin";
         sprintf(zetaBinary, "%s%s", zeta_file, bin);
 	FILE* pzetaBinary;
 	int e = 0;
+	*zetaHat = 0;
+	*zetaValid = 0;
 	if (pzetaBinary = fopen(zetaBinary, "rb"))
 	{
 		int nvals = 0;
@@ -221,30 +287,32 @@ int readZetaHat(const char* zeta_file, int* rows, int* cols,
 		if (e == 0 && fread(gmax,      sizeof(double), 1,     pzetaBinary) != 1) e = 1;
 		if (e == 0 && fread(ximin,     sizeof(double), 1,     pzetaBinary) != 1) e = 1;
 		if (e == 0 && fread(ximax,     sizeof(double), 1,     pzetaBinary) != 1) e = 1;
-		if (e == 0)   nvals = (*rows) * (*cols);
-		if (e == 0 && fread(zetaHat,   sizeof(double), nvals, pzetaBinary) != nvals) e = 1;
-		if (e == 0 && fread(zetaValid, sizeof(int),    nvals, pzetaBinary) != nvals) e = 1;
+		if (e == 0 && (*rows < 1 || *rows > 1024 || *cols != *rows || !(*gmax > *gmin) || !(*ximax > *ximin))) e = 1;
+		if (e == 0)
+		{
+			nvals = (*rows) * (*cols);
+			*zetaHat   = (double *)malloc0 (nvals * sizeof (double));
+			*zetaValid = (int *)   malloc0 (nvals * sizeof (int));
+		}
+		if (e == 0 && fread(*zetaHat,   sizeof(double), nvals, pzetaBinary) != nvals) e = 1;
+		if (e == 0 && fread(*zetaValid, sizeof(int),    nvals, pzetaBinary) != nvals) e = 1;
 		fclose(pzetaBinary);
         }
 	else 
 		e = 1;
 	if (e)
 	{
-		*rows  = CzetaRows;
-		*cols  = CzetaCols;
-		*gmin  = CzetaGmin;
-		*gmax  = CzetaGmax;
-		*ximin = CzetaXimin;
-		*ximax = CzetaXimax;
-        int nvals = (*rows) * (*cols);
-		memcpy (zetaHat,   CzetaHat,   nvals * sizeof (double));
-		memcpy (zetaValid, CzetaValid, nvals * sizeof (int));
+		_aligned_free (*zetaValid);
+		_aligned_free (*zetaHat);
+		*zetaHat = 0;
+		*zetaValid = 0;
+		return -1;
 	}
         return 0;
 }
 
 void CwriteZetaHat(const char* cfile, int zetaHat_rows, int zetaHat_cols,
-	double zetaHat_gmin, double zetaHat_gmax, double zetaHat_ximin, double zetaHat_ximax, double* zetaHat, int* zetaValid)
+	double zetaHat_gmin, double zetaHat_gmax, double zetaHat_ximin, double zetaHat_ximax, const double* zetaHat, const int* zetaValid)
 {
 	int n, i, j;
 	char cfilename[256];
@@ -253,14 +321,14 @@ void CwriteZetaHat(const char* cfile, int zetaHat_rows, int zetaHat_cols,
 	FILE* pcfile;
 	if (pcfile = fopen(cfilename, "w"))
 	{
-		fprintf(pcfile, "int CzetaRows = %d;\n",        zetaHat_rows);
-		fprintf(pcfile, "int CzetaCols = %d;\n",        zetaHat_cols);
-		fprintf(pcfile, "double CzetaGmin = %lf;\n",    zetaHat_gmin);
-		fprintf(pcfile, "double CzetaGmax = %lf;\n",    zetaHat_gmax);
-		fprintf(pcfile, "double CzetaXimin = %lf;\n",   zetaHat_ximin);
-		fprintf(pcfile, "double CzetaXimax = %lf;\n\n", zetaHat_ximax);
+		fprintf(pcfile, "const int CzetaRows = %d;\n",        zetaHat_rows);
+		fprintf(pcfile, "const int CzetaCols = %d;\n",        zetaHat_cols);
+		fprintf(pcfile, "const double CzetaGmin = %lf;\n",    zetaHat_gmin);
+		fprintf(pcfile, "const double CzetaGmax = %lf;\n",    zetaHat_gmax);
+		fprintf(pcfile, "const double CzetaXimin = %lf;\n",   zetaHat_ximin);
+		fprintf(pcfile, "const double CzetaXimax = %lf;\n\n", zetaHat_ximax);
 		n = zetaHat_rows * zetaHat_cols;
-		fprintf(pcfile, "double CzetaHat [%d] =\n", n);
+		fprintf(pcfile, "const double CzetaHat [%d] =\n", n);
 		fprintf(pcfile, "{\n");
 		i = 0;
 		j = 0;
@@ -275,7 +343,7 @@ void CwriteZetaHat(const char* cfile, int zetaHat_rows, int zetaHat_cols,
 		}
 		if (j != 0) fprintf(pcfile, "\n");
 		fprintf(pcfile, "};\n\n");
-		fprintf(pcfile, "int CzetaValid [%d] =\n", n);
+		fprintf(pcfile, "const int CzetaValid [%d] =\n", n);
 		fprintf(pcfile, "{\n");
 		i = 0;
 		j = 0;
@@ -296,6 +364,103 @@ void CwriteZetaHat(const char* cfile, int zetaHat_rows, int zetaHat_cols,
 }
 
 
+/********************************************************************************************************
+*																										*
+*								    Shared Gain and Zeta Tables											*
+*																										*
+********************************************************************************************************/
+
+// The GG / GGS gain tables and the zetaHat table are read-only after loading and are shared by every
+// EMNR instance in the process.  They are loaded on first use:  from the "calculus" and "zetaHat.bin"
+// files in the working directory if present and well-formed, otherwise the instances point straight at
+// the compiled-in tables, which are const and live in the library's read-only image.
+
+#define EMNR_GG_DIM			241
+
+static struct
+{
+	const double* GG;
+	const double* GGS;
+	int zeta_dim;
+	const double* zeta_hat;
+	const int* zeta_true;
+	double z_gamma_min;
+	double z_gamma_max;
+	double z_xihat_min;
+	double z_xihat_max;
+} emnr_tables;
+static volatile LONG emnr_tables_state;				// 0 = not loaded, 1 = loading, 2 = ready
+
+static int emnr_read_calculus (const char* name)
+{
+	const int n = EMNR_GG_DIM * EMNR_GG_DIM;
+	double* gg;
+	FILE* file;
+	int e = 0;
+	if ((file = fopen (name, "rb")) == 0)
+		return -1;
+	// the file holds exactly GG followed by GGS
+	if (fseek (file, 0, SEEK_END) != 0 || ftell (file) != (long)(2 * n * sizeof (double))) e = 1;
+	if (e == 0 && fseek (file, 0, SEEK_SET) != 0) e = 1;
+	if (e == 0)
+	{
+		gg = (double *)malloc0 (2 * n * sizeof (double));
+		if (fread (gg, sizeof (double), 2 * n, file) != 2 * n)
+		{
+			_aligned_free (gg);
+			e = 1;
+		}
+	}
+	fclose (file);
+	if (e)
+		return -1;
+	emnr_tables.GG  = gg;
+	emnr_tables.GGS = gg + n;
+	return 0;
+}
+
+static void emnr_tables_load (void)
+{
+	int rows, cols;
+	double* zhat;
+	int* ztrue;
+	if (ReadAcquire (&emnr_tables_state) == 2)
+		return;
+	if (InterlockedCompareExchange (&emnr_tables_state, 1, 0) != 0)
+	{
+		// another thread is loading
+		while (ReadAcquire (&emnr_tables_state) != 2)
+			Sleep (0);
+		return;
+	}
+	if (emnr_read_calculus ("calculus") != 0)
+	{
+		emnr_tables.GG  = GG;
+		emnr_tables.GGS = GGS;
+	}
+	if (readZetaHat ("zetaHat", &rows, &cols, &emnr_tables.z_gamma_min, &emnr_tables.z_gamma_max,
+		&emnr_tables.z_xihat_min, &emnr_tables.z_xihat_max, &zhat, &ztrue) == 0)
+	{
+		emnr_tables.zeta_dim  = rows;
+		emnr_tables.zeta_hat  = zhat;
+		emnr_tables.zeta_true = ztrue;
+	}
+	else
+	{
+		emnr_tables.zeta_dim    = CzetaRows;
+		emnr_tables.z_gamma_min = CzetaGmin;
+		emnr_tables.z_gamma_max = CzetaGmax;
+		emnr_tables.z_xihat_min = CzetaXimin;
+		emnr_tables.z_xihat_max = CzetaXimax;
+		emnr_tables.zeta_hat    = CzetaHat;
+		emnr_tables.zeta_true   = CzetaValid;
+	}
+	WriteRelease (&emnr_tables_state, 2);
+}
+
+
+static void emnr_mask (void* arg, double* spec, double* mask);
+
 void calc_emnr(EMNR a)
 {
 	int i;
@@ -307,51 +472,25 @@ void calc_emnr(EMNR a)
 		3.100, 3.380, 4.150, 4.350, 4.250, 3.900, 4.100, 4.700, 5.000 };
 	a->incr = a->fsize / a->ovrlp;
 	a->gain = a->ogain / a->fsize / (double)a->ovrlp;
-	if (a->fsize > a->bsize)
-		a->iasize = a->fsize;
-	else
-		a->iasize = a->bsize + a->fsize - a->incr;
-	a->iainidx = 0;
-	a->iaoutidx = 0;
-	if (a->fsize > a->bsize)
-	{
-		if (a->bsize > a->incr)  a->oasize = a->bsize;
-		else					 a->oasize = a->incr;
-		a->oainidx = (a->fsize - a->bsize - a->incr) % a->oasize;
-	}
-	else
-	{
-		a->oasize = a->bsize;
-		a->oainidx = a->fsize - a->incr;
-	}
-	a->init_oainidx = a->oainidx;
-	a->oaoutidx = 0;
 	a->msize = a->fsize / 2 + 1;
 	a->window = (double *)malloc0(a->fsize * sizeof(double));
-	a->inaccum = (double *)malloc0(a->iasize * sizeof(double));
-	a->forfftin = (double *)malloc0(a->fsize * sizeof(double));
-	a->forfftout = (double *)malloc0(a->msize * sizeof(complex));
-	a->mask = (double *)malloc0(a->msize * sizeof(double));
-	a->revfftin = (double *)malloc0(a->msize * sizeof(complex));
-	a->revfftout = (double *)malloc0(a->fsize * sizeof(double));
-	a->save = (double **)malloc0(a->ovrlp * sizeof(double *));
-	for (i = 0; i < a->ovrlp; i++)
-		a->save[i] = (double *)malloc0(a->fsize * sizeof(double));
-	a->outaccum = (double *)malloc0(a->oasize * sizeof(double));
-	a->nsamps = 0;
-	a->saveidx = 0;
-	a->Rfor = fftw_plan_dft_r2c_1d(a->fsize, a->forfftin, (fftw_complex *)a->forfftout, FFTW_ESTIMATE);
-	a->Rrev = fftw_plan_dft_c2r_1d(a->fsize, (fftw_complex *)a->revfftin, a->revfftout, FFTW_ESTIMATE);
 	calc_window(a);
+	a->stft = create_stft(a->bsize, a->fsize, a->ovrlp, STFT_DOUBLE, a->window,
+		1.0, a->gain, 1.0, emnr_mask, a);
+	a->mask = a->stft->mask;
     //
     // g
 	a->g.msize = a->msize;
 	a->g.mask = a->mask;
-	a->g.y = a->forfftout;
+	a->g.y = a->stft->spec;
 	a->g.lambda_y = (double *)malloc0(a->msize * sizeof(double));
 	a->g.lambda_d = (double *)malloc0(a->msize * sizeof(double));
 	a->g.prev_gamma = (double *)malloc0(a->msize * sizeof(double));
 	a->g.prev_mask = (double *)malloc0(a->msize * sizeof(double));
+	a->g.gamma = (double *)malloc0(a->msize * sizeof(double));
+	a->g.xi = (double *)malloc0(a->msize * sizeof(double));
+	if (!ReadAcquire (&emnr_tab_ready))
+		emnr_tab_init ();
 
 	a->g.gf1p5 = sqrt(PI) / 2.0;
 	{
@@ -369,27 +508,19 @@ void calc_emnr(EMNR a)
 	}
 	a->g.gmax = 10000.0;
 	//
-	a->g.GG = (double *)malloc0(241 * 241 * sizeof(double));
-	a->g.GGS = (double *)malloc0(241 * 241 * sizeof(double));
-        if (a->g.fileb = fopen("calculus", "rb"))
-	{
-		fread(a->g.GG, sizeof(double), 241 * 241, a->g.fileb);
-		fread(a->g.GGS, sizeof(double), 241 * 241, a->g.fileb);
-		fclose(a->g.fileb);
-	}
-	else
-	{
-		memcpy (a->g.GG,  GG,  241 * 241 * sizeof(double));
-		memcpy (a->g.GGS, GGS, 241 * 241 * sizeof(double));
-	}
+	emnr_tables_load();
+	a->g.GG = emnr_tables.GG;
+	a->g.GGS = emnr_tables.GGS;
 	//
-        a->g.dim_zeta = 60;
-        a->g.zeta_hat = (double*)malloc0(a->g.dim_zeta * a->g.dim_zeta * sizeof(double));
-        a->g.zeta_true = (int*)  malloc0(a->g.dim_zeta * a->g.dim_zeta * sizeof(int));
+        a->g.dim_zeta = emnr_tables.zeta_dim;
+        a->g.zeta_hat = emnr_tables.zeta_hat;
+        a->g.zeta_true = emnr_tables.zeta_true;
+        a->g.z_gamma_min = emnr_tables.z_gamma_min;
+        a->g.z_gamma_max = emnr_tables.z_gamma_max;
+        a->g.z_xihat_min = emnr_tables.z_xihat_min;
+        a->g.z_xihat_max = emnr_tables.z_xihat_max;
         a->g.zeta_thresh = -2.0;
-        int rows, cols;
-        readZetaHat("zetaHat", &rows, &cols, &a->g.z_gamma_min, &a->g.z_gamma_max, &a->g.z_xihat_min, &a->g.z_xihat_max, a->g.zeta_hat, a->g.zeta_true);
-	// CwriteZetaHat("zetaHat", rows, cols, a->g.z_gamma_min, a->g.z_gamma_max, a->g.z_xihat_min, a->g.z_xihat_max, a->g.zeta_hat, a->g.zeta_true);
+	// CwriteZetaHat("zetaHat", a->g.dim_zeta, a->g.dim_zeta, a->g.z_gamma_min, a->g.z_gamma_max, a->g.z_xihat_min, a->g.z_xihat_max, a->g.zeta_hat, a->g.zeta_true);
         // np
 	a->np.incr = a->incr;
 	a->np.rate = a->rate;
@@ -592,27 +723,14 @@ void decalc_emnr(EMNR a)
 	_aligned_free(a->np.alphaOptHat);
 	_aligned_free(a->np.p);
     // g
-    _aligned_free(a->g.zeta_true);
-    _aligned_free(a->g.zeta_hat);
-	_aligned_free(a->g.GGS);
-	_aligned_free(a->g.GG);
+	_aligned_free(a->g.xi);
+	_aligned_free(a->g.gamma);
 	_aligned_free(a->g.prev_mask);
 	_aligned_free(a->g.prev_gamma);
 	_aligned_free(a->g.lambda_d);
 	_aligned_free(a->g.lambda_y);
     //
-	fftw_destroy_plan(a->Rrev);
-	fftw_destroy_plan(a->Rfor);
-	_aligned_free(a->outaccum);
-	for (i = 0; i < a->ovrlp; i++)
-		_aligned_free(a->save[i]);
-	_aligned_free(a->save);
-	_aligned_free(a->revfftout);
-	_aligned_free(a->revfftin);
-	_aligned_free(a->mask);
-	_aligned_free(a->forfftout);
-	_aligned_free(a->forfftin);
-	_aligned_free(a->inaccum);
+	destroy_stft(a->stft);
 	_aligned_free(a->window);
 }
 
@@ -640,17 +758,7 @@ EMNR create_emnr (int run, int position, int size, double* in, double* out, int
 
 void flush_emnr (EMNR a)
 {
-	int i;
-	memset (a->inaccum, 0, a->iasize * sizeof (double));
-	for (i = 0; i < a->ovrlp; i++)
-		memset (a->save[i], 0, a->fsize * sizeof (double));
-	memset (a->outaccum, 0, a->oasize * sizeof (double));
-	a->nsamps   = 0;
-	a->iainidx  = 0;
-	a->iaoutidx = 0;
-	a->oainidx  = a->init_oainidx;
-	a->oaoutidx = 0;
-	a->saveidx  = 0;
+	flush_stft (a->stft);
 }
 
 void destroy_emnr (EMNR a)
@@ -659,19 +767,97 @@ void destroy_emnr (EMNR a)
 	_aligned_free (a);
 }
 
+// Per-bin kernels for LambdaD() and calc_gain().  The arrays are separate restrict-qualified
+// parameters and the conditionals are written as selects, so the loops vectorize.
+
+// smoothing parameters, smoothed power and its first two moments; returns the sum of 1/Qeq and
+// leaves 1/Qeq in 'Qeq' for npest_minima()
+static double npest_smooth (int n, double alphaMin, double f2, double betamax, double invQeqMax,
+	double* __restrict p, const double* __restrict sigma2N, const double* __restrict lambda_y,
+	double* __restrict alphaOptHat, double* __restrict alphaHat, double* __restrict pbar,
+	double* __restrict p2bar, double* __restrict Qeq)
+{
+	int k;
+	double f0, aopt, pk, beta, varHat, invQeq, invQbar;
+	for (k = 0; k < n; k++)
+	{
+		f0 = p[k] / sigma2N[k] - 1.0;
+		aopt = 1.0 / (1.0 + f0 * f0);
+		aopt = aopt < alphaMin ? alphaMin : aopt;
+		alphaOptHat[k] = aopt;
+		alphaHat[k] = f2 * aopt;
+		pk = alphaHat[k] * p[k] + (1.0 - alphaHat[k]) * lambda_y[k];
+		p[k] = pk;
+		beta = min (betamax, alphaHat[k] * alphaHat[k]);
+		pbar[k] = beta * pbar[k] + (1.0 - beta) * pk;
+		p2bar[k] = beta * p2bar[k] + (1.0 - beta) * pk * pk;
+		varHat = p2bar[k] - pbar[k] * pbar[k];
+		invQeq = varHat / (2.0 * sigma2N[k] * sigma2N[k]);
+		Qeq[k] = invQeq > invQeqMax ? invQeqMax : invQeq;
+	}
+	invQbar = 0.0;
+	for (k = 0; k < n; k++)
+		invQbar += Qeq[k];
+	return invQbar;
+}
+
+// bias corrections, then the running minima; the minima loop is kept apart since the compiler will
+// not if-convert its two-way updates
+static void npest_minima (int n, double bc, double MofD, double MofV, double Dm1, double Vm1,
+	const double* __restrict p, double* __restrict Qeq, double* __restrict bmin, double* __restrict bmin_sub,
+	double* __restrict actmin, double* __restrict actmin_sub, int* __restrict k_mod)
+{
+	int k;
+	double QeqTilda, QeqTildaSub, f3;
+	for (k = 0; k < n; k++)
+	{
+		Qeq[k] = 1.0 / Qeq[k];
+		QeqTilda    = (Qeq[k] - 2.0 * MofD) / (1.0 - MofD);
+		QeqTildaSub = (Qeq[k] - 2.0 * MofV) / (1.0 - MofV);
+		bmin[k]     = 1.0 + Dm1 / QeqTilda;
+		bmin_sub[k] = 1.0 + Vm1 / QeqTildaSub;
+	}
+	for (k = 0; k < n; k++)
+	{
+		f3 = p[k] * bmin[k] * bc;
+		k_mod[k] = f3 < actmin[k];
+		if (k_mod[k])
+		{
+			actmin[k] = f3;
+			actmin_sub[k] = p[k] * bmin_sub[k] * bc;
+		}
+	}
+}
+
+// E&M: equation 10 (a-posteriori SNR, gamma) and equations 51 and 52 (decision-directed a-priori SNR, xi)
+static void emnr_snr (int n, double gamma_max, double eps_floor, double alpha,
+	const double* __restrict lambda_y, const double* __restrict lambda_d, const double* __restrict prev_mask,
+	const double* __restrict prev_gamma, double* __restrict gamma, double* __restrict xi)
+{
+	int k;
+	double g, d;
+	for (k = 0; k < n; k++)
+	{
+		g = lambda_y[k] / lambda_d[k];
+		g = g < gamma_max ? g : gamma_max;
+		d = g - 1.0;
+		d = d < eps_floor ? eps_floor : d;
+		gamma[k] = g;
+		xi[k] = alpha * prev_mask[k] * prev_mask[k] * prev_gamma[k] + (1.0 - alpha) * d;
+	}
+}
+
 void LambdaD(EMNR a)
 {
 	int k;
-	double f0, f1, f2, f3;
+	double f1, f2;
 	double sum_prev_p;
 	double sum_lambda_y;
 	double alphaCtilda;
 	double sum_prev_sigma2N;
 	double alphaMin, SNR;
-	double beta, varHat, invQeq;
 	double invQbar;
 	double bc;
-	double QeqTilda, QeqTildaSub;
 	double noise_slope_max;
 	
 	sum_prev_p = 0.0;
@@ -683,55 +869,18 @@ void LambdaD(EMNR a)
 		sum_lambda_y += a->np.lambda_y[k];
 		sum_prev_sigma2N += a->np.sigma2N[k];
 	}
-	for (k = 0; k < a->np.msize; k++)
-	{
-		f0 = a->np.p[k] / a->np.sigma2N[k] - 1.0;
-		a->np.alphaOptHat[k] = 1.0 / (1.0 + f0 * f0);
-	}
 	SNR = sum_prev_p / sum_prev_sigma2N;
 	alphaMin = min (a->np.alphaMin_max_value, pow (SNR, a->np.snrq));
-	for (k = 0; k < a->np.msize; k++)
-		if (a->np.alphaOptHat[k] < alphaMin) a->np.alphaOptHat[k] = alphaMin;
 	f1 = sum_prev_p / sum_lambda_y - 1.0;
 	alphaCtilda = 1.0 / (1.0 + f1 * f1);
 	a->np.alphaC = a->np.alphaCsmooth * a->np.alphaC + (1.0 - a->np.alphaCsmooth) * max (alphaCtilda, a->np.alphaCmin);
 	f2 = a->np.alphaMax * a->np.alphaC;
-	for (k = 0; k < a->np.msize; k++)
-		a->np.alphaHat[k] = f2 * a->np.alphaOptHat[k];
-	for (k = 0; k < a->np.msize; k++)
-		a->np.p[k] = a->np.alphaHat[k] * a->np.p[k] + (1.0 - a->np.alphaHat[k]) * a->np.lambda_y[k];
-	invQbar = 0.0;
-	for (k = 0; k < a->np.msize; k++)
-	{
-		beta = min (a->np.betamax, a->np.alphaHat[k] * a->np.alphaHat[k]);
-		a->np.pbar[k] = beta * a->np.pbar[k] + (1.0 - beta) * a->np.p[k];
-		a->np.p2bar[k] = beta * a->np.p2bar[k] + (1.0 - beta) * a->np.p[k] * a->np.p[k];
-		varHat = a->np.p2bar[k] - a->np.pbar[k] * a->np.pbar[k];
-		invQeq = varHat / (2.0 * a->np.sigma2N[k] * a->np.sigma2N[k]);
-		if (invQeq > a->np.invQeqMax) invQeq = a->np.invQeqMax;
-		a->np.Qeq[k] = 1.0 / invQeq;
-		invQbar += invQeq;
-	}
+	invQbar = npest_smooth (a->np.msize, alphaMin, f2, a->np.betamax, a->np.invQeqMax, a->np.p, a->np.sigma2N,
+		a->np.lambda_y, a->np.alphaOptHat, a->np.alphaHat, a->np.pbar, a->np.p2bar, a->np.Qeq);
 	invQbar /= (double)a->np.msize;
 	bc = 1.0 + a->np.av * sqrt (invQbar);
-	for (k = 0; k < a->np.msize; k++)
-	{
-		QeqTilda    = (a->np.Qeq[k] - 2.0 * a->np.MofD) / (1.0 - a->np.MofD);
-		QeqTildaSub = (a->np.Qeq[k] - 2.0 * a->np.MofV) / (1.0 - a->np.MofV);
-		a->np.bmin[k]     = 1.0 + 2.0 * (a->np.D - 1.0) / QeqTilda;
-		a->np.bmin_sub[k] = 1.0 + 2.0 * (a->np.V - 1.0) / QeqTildaSub;
-	}
-	memset (a->np.k_mod, 0, a->np.msize * sizeof (int));
-	for (k = 0; k < a->np.msize; k++)
-	{
-		f3 = a->np.p[k] * a->np.bmin[k] * bc;
-		if (f3 < a->np.actmin[k])
-		{
-			a->np.actmin[k] = f3;
-			a->np.actmin_sub[k] = a->np.p[k] * a->np.bmin_sub[k] * bc;
-			a->np.k_mod[k] = 1;
-		}
-	}
+	npest_minima (a->np.msize, bc, a->np.MofD, a->np.MofV, 2.0 * (a->np.D - 1.0), 2.0 * (a->np.V - 1.0),
+		a->np.p, a->np.Qeq, a->np.bmin, a->np.bmin_sub, a->np.actmin, a->np.actmin_sub, a->np.k_mod);
 	if (a->np.subwc == a->np.V)
 	{
 		if      (invQbar < a->np.invQbar_points[0]) noise_slope_max = a->np.nsmax[0];
@@ -876,7 +1025,7 @@ void aepf(EMNR a)
             a->mask[k] *= 0.05;
 }
 
-double getKey(double* type, double gamma, double xi)
+double getKey(const double* type, double gamma, double xi)
 {
 	int ngamma1, ngamma2, nxi1, nxi2;
 	double tg, tx, dg, dx;
@@ -947,6 +1096,7 @@ int getZeta( EMNR a, double gamma, double eps, double* zeta)
 void calc_gain (EMNR a)
 {
 	int k;
+	double* tmp;
 	for (k = 0; k < a->g.msize; k++)
 	{
 		a->g.lambda_y[k] = a->g.y[2 * k + 0] * a->g.y[2 * k + 0] + a->g.y[2 * k + 1] * a->g.y[2 * k + 1];
@@ -963,6 +1113,8 @@ void calc_gain (EMNR a)
         LambdaDl(a);
         break;
 	}
+	emnr_snr (a->msize, a->g.gamma_max, a->g.eps_floor, a->g.alpha,
+		a->g.lambda_y, a->g.lambda_d, a->g.prev_mask, a->g.prev_gamma, a->g.gamma, a->g.xi);
 	switch (a->g.gain_method)
 	{
 	case 0: // gaussian speech, linear amplitude
@@ -970,17 +1122,16 @@ void calc_gain (EMNR a)
 			double gamma, eps_hat, v;
             for (k = 0; k < a->g.msize; k++)
 			{
-                            // E&M: equation 10
-				gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-                                // E&M: equation 51 and 52 -> 53?
-				eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
-                                eps_hat = max(eps_hat, a->g.xi_min);
+				gamma = a->g.gamma[k];
+				eps_hat = max (a->g.xi[k], a->g.xi_min);
                                 // E&M: equation 8
 				v = (eps_hat / (1.0 + eps_hat)) * gamma;
                                 // E&M: equation 7
-				a->g.mask[k] = a->g.gf1p5 * sqrt (v) / gamma * exp (- 0.5 * v)
-					* ((1.0 + v) * bessI0 (0.5 * v) + v * bessI1 (0.5 * v));
+				if (v < EMNR_VMAX)
+					a->g.mask[k] = emnr_interp (emnr_mmse_tab, sqrt (v)) / gamma;
+				else
+					a->g.mask[k] = a->g.gf1p5 * sqrt (v) / gamma * exp (- 0.5 * v)
+						* ((1.0 + v) * bessI0 (0.5 * v) + v * bessI1 (0.5 * v));
                                 // at this point, mask variable
                                 // contains Â_k, the estimated
                                 // amplitude of speech signal.
@@ -1001,9 +1152,8 @@ void calc_gain (EMNR a)
 				}
 				if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
 				if (a->g.mask[k] != a->g.mask[k]) a->g.mask[k] = 0.01;
-				a->g.prev_gamma[k] = gamma;
-				a->g.prev_mask[k] = a->g.mask[k];
 			}
+			memcpy (a->g.prev_mask, a->g.mask, a->g.msize * sizeof (double));
 			break;
 		}
 	case 1: // gaussian speech, log amplitude
@@ -1011,16 +1161,18 @@ void calc_gain (EMNR a)
 			double gamma, eps_hat, v, ehr;
 			for (k = 0; k < a->g.msize; k++)
 			{
-				gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-				eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
+				gamma = a->g.gamma[k];
+				eps_hat = a->g.xi[k];
 				ehr = eps_hat / (1.0 + eps_hat);
 				v = ehr * gamma;
-				if((a->g.mask[k] = ehr * exp (min (700.0, 0.5 * e1xb(v)))) > a->g.gmax) a->g.mask[k] = a->g.gmax;
+				if (v > 0.0 && v < EMNR_VMAX)
+					a->g.mask[k] = ehr * emnr_interp (emnr_lsa_tab, sqrt (v)) / sqrt (v);
+				else
+					a->g.mask[k] = ehr * exp (min (700.0, 0.5 * e1xb(v)));
+				if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
 				if (a->g.mask[k] != a->g.mask[k])a->g.mask[k] = 0.01;
-				a->g.prev_gamma[k] = gamma;
-				a->g.prev_mask[k] = a->g.mask[k];
 			}
+			memcpy (a->g.prev_mask, a->g.mask, a->g.msize * sizeof (double));
 			break;
 		}
 	case 2: // gamma speech distribution (default)
@@ -1028,14 +1180,12 @@ void calc_gain (EMNR a)
 			double gamma, eps_hat, eps_p;
 			for (k = 0; k < a->g.msize; k++)
 			{
-				gamma = min(a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-				eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-					+ (1.0 - a->g.alpha) * max(gamma - 1.0, a->g.eps_floor);
+				gamma = a->g.gamma[k];
+				eps_hat = a->g.xi[k];
 				eps_p = eps_hat / (1.0 - a->g.q);
 				a->g.mask[k] = getKey(a->g.GG, gamma, eps_hat) * getKey(a->g.GGS, gamma, eps_p);
-				a->g.prev_gamma[k] = gamma;
-				a->g.prev_mask[k] = a->g.mask[k];
 			}
+			memcpy (a->g.prev_mask, a->g.mask, a->g.msize * sizeof (double));
 			break;
 		}
     case 3:
@@ -1043,13 +1193,14 @@ void calc_gain (EMNR a)
             double gamma, xi_hat, v, zeta_hat;
             for (k = 0; k < a->g.msize; k++)
             {
-                gamma = min(a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-                xi_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-                    + (1.0 - a->g.alpha) * max(gamma - 1.0, a->g.eps_floor);
-                xi_hat = max(xi_hat, a->g.xi_min);
+                gamma = a->g.gamma[k];
+                xi_hat = max(a->g.xi[k], a->g.xi_min);
                 v = (xi_hat / (1.0 + xi_hat)) * gamma;
-                a->g.mask[k] = a->g.gf1p5 * sqrt(v) / gamma * exp(-0.5 * v)
-                    * ((1.0 + v) * bessI0(0.5 * v) + v * bessI1(0.5 * v));
+                if (v < EMNR_VMAX)
+                    a->g.mask[k] = emnr_interp(emnr_mmse_tab, sqrt(v)) / gamma;
+                else
+                    a->g.mask[k] = a->g.gf1p5 * sqrt(v) / gamma * exp(-0.5 * v)
+                        * ((1.0 + v) * bessI0(0.5 * v) + v * bessI1(0.5 * v));
                 {
                     double v2 = min(v, 700.0);
                     double eta = a->g.mask[k] * a->g.mask[k] * a->g.lambda_y[k] / a->g.lambda_d[k];
@@ -1060,14 +1211,16 @@ void calc_gain (EMNR a)
                 if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
                 if (a->g.mask[k] != a->g.mask[k]) a->g.mask[k] = 0.01;
                 a->g.prev_mask[k] = a->g.mask[k];
-                a->g.prev_gamma[k] = gamma;
 
                 {
                     double xi_ts = a->g.mask[k] * a->g.mask[k] * gamma;
                     xi_ts = max(xi_ts, a->g.xi_min);
                     double v_ts = (xi_ts / (1.0 + xi_ts)) * gamma;
-                    a->g.mask[k] = a->g.gf1p5 * sqrt(v_ts) / gamma * exp(-0.5 * v_ts)
-                        * ((1.0 + v_ts) * bessI0(0.5 * v_ts) + v_ts * bessI1(0.5 * v_ts));
+                    if (v_ts < EMNR_VMAX)
+                        a->g.mask[k] = emnr_interp(emnr_mmse_tab, sqrt(v_ts)) / gamma;
+                    else
+                        a->g.mask[k] = a->g.gf1p5 * sqrt(v_ts) / gamma * exp(-0.5 * v_ts)
+                            * ((1.0 + v_ts) * bessI0(0.5 * v_ts) + v_ts * bessI1(0.5 * v_ts));
 		    double v2 = min(v_ts, 700.0);
                     double eta = a->g.mask[k] * a->g.mask[k] * a->g.lambda_y[k] / a->g.lambda_d[k];
                     double eps = eta / (1.0 - a->g.q);
@@ -1087,71 +1240,24 @@ void calc_gain (EMNR a)
             break;
         }
     }
+	// this frame's gamma becomes the next frame's prev_gamma
+	tmp = a->g.prev_gamma;
+	a->g.prev_gamma = a->g.gamma;
+	a->g.gamma = tmp;
 	if (a->g.ae_run) aepf(a);
 }
 
+// STFT callback:  estimate the noise power from the spectrum (a->g.y) and compute the gains (a->mask)
+static void emnr_mask (void* arg, double* spec, double* mask)
+{
+	calc_gain ((EMNR)arg);
+}
+
 void xemnr (EMNR a, int pos)
 {
 	if (a->run && pos == a->position)
 	{
-		int i, j, k, sbuff, sbegin;
-		double g1;
-		for (i = 0; i < 2 * a->bsize; i += 2)
-		{
-			a->inaccum[a->iainidx] = a->in[i];
-			a->iainidx = (a->iainidx + 1) % a->iasize;
-		}
-		a->nsamps += a->bsize;
-		while (a->nsamps >= a->fsize)
-		{
-			for (i = 0, j = a->iaoutidx; i < a->fsize; i++, j = (j + 1) % a->iasize)
-				a->forfftin[i] = a->window[i] * a->inaccum[j];
-			a->iaoutidx = (a->iaoutidx + a->incr) % a->iasize;
-			a->nsamps -= a->incr;
-
-                        // step 1: find PSD
-			fftw_execute (a->Rfor);
-
-                        // step 2: calc noise power and then calc gain (a->mask[i])
-                        // multiply each complex output value of the spectrum by gain.
-                        calc_gain(a);
-                        // output is the Â_k values (a->mask[k])
-			for (i = 0; i < a->msize; i++)
-			{
-				g1 = a->gain * a->mask[i];
-				a->revfftin[2 * i + 0] = g1 * a->forfftout[2 * i + 0];
-				a->revfftin[2 * i + 1] = g1 * a->forfftout[2 * i + 1];
-			}
-
-                        // step 3: find inverse fft (i.e. we are in time domain again)
-			fftw_execute (a->Rrev);
-
-                        // step 4: windowing after synthesis.
-			for (i = 0; i < a->fsize; i++)
-				a->save[a->saveidx][i] = a->window[i] * a->revfftout[i];
-
-                        // step 5: overlap save for next frame
-			for (i = a->ovrlp; i > 0; i--)
-			{
-				sbuff = (a->saveidx + i) % a->ovrlp;
-				sbegin = a->incr * (a->ovrlp - i);
-				for (j = sbegin, k = a->oainidx; j < a->incr + sbegin; j++, k = (k + 1) % a->oasize)
-				{
-					if ( i == a->ovrlp)
-						a->outaccum[k]  = a->save[sbuff][j];
-					else
-						a->outaccum[k] += a->save[sbuff][j];
-				}
-			}
-			a->saveidx = (a->saveidx + 1) % a->ovrlp;
-			a->oainidx = (a->oainidx + a->incr) % a->oasize;
-		}
-		for (i = 0; i < a->bsize; i++)
-		{
-			a->out[2 * i + 0] = a->outaccum[a->oaoutidx];
-			a->out[2 * i + 1] = 0.0;
-			a->oaoutidx = (a->oaoutidx + 1) % a->oasize;
-		}
+		xstft (a->stft, a->in, a->out);
 	}
 	else if (a->out != a->in)
 		memcpy (a->out, a->in, a->bsize * sizeof (complex));
@@ -1235,6 +1341,7 @@ void SetRXAEMNRPosition (int channel, int position)
 	EnterCriticalSection (&ch[channel].csDSP);
 	rxa[channel].emnr.p->position = position;
 	rxa[channel].bp1.p->position  = position;
+	RXAeqbp1Set (channel);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
@@ -38,30 +38,13 @@ typedef struct _emnr
 	int ovrlp;
 	int incr;
 	double* window;
-	int iasize;
-	double* inaccum;
-	double* forfftin;
-	double* forfftout;
 	int msize;
 	double* mask;
-	double* revfftin;
-	double* revfftout;
-	double** save;
-	int oasize;
-	double* outaccum;
 	double rate;
 	int wintype;
 	double ogain;
 	double gain;
-	int nsamps;
-	int iainidx;
-	int iaoutidx;
-	int init_oainidx;
-	int oainidx;
-	int oaoutidx;
-	int saveidx;
-	fftw_plan Rfor;
-	fftw_plan Rrev;
+	STFT stft;
 	struct _g
 	{
 		int gain_method;
@@ -74,6 +57,8 @@ typedef struct _emnr
 		double* lambda_d;
 		double* prev_mask;
 		double* prev_gamma;
+		double* gamma;
+		double* xi;
 		double gf1p5;
 		double alpha;
 		double eps_floor;
@@ -82,13 +67,12 @@ typedef struct _emnr
 		double q;
 		double gmax;
 		//
-		double* GG;
-		double* GGS;
-		FILE* fileb;
+		const double* GG;					// shared, see emnr_tables_load()
+		const double* GGS;
         //
         int dim_zeta;
-        double* zeta_hat;
-        int* zeta_true;
+        const double* zeta_hat;
+        const int* zeta_true;
         double z_gamma_min;
         double z_gamma_max;
         double z_xihat_min;
@@ -204,4 +188,8 @@ extern void setSamplerate_emnr (EMNR a, int rate);
 
 extern void setSize_emnr (EMNR a, int size);
 
+// RXA Properties
+
+extern __declspec (dllexport) void SetRXAEMNRRun (int channel, int run);
+
 #endif
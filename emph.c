@@ -48,7 +48,7 @@ EMPHP create_emphp (int run, int position, int size, int nc, int mp, double* in,
 	a->f_low = f_low;
 	a->f_high = f_high;
 	impulse = fc_impulse (a->nc, a->f_low, a->f_high, -20.0 * log10(a->f_high / a->f_low), 0.0, a->ctype, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, 0);
 	_aligned_free (impulse);
 	return a;
 }
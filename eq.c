@@ -219,7 +219,7 @@ EQP create_eqp (int run, int size, int nc, int mp, double *in, double *out, int
 	a->wintype = wintype;
 	a->samplerate = (double)samplerate;
 	impulse = eq_impulse (a->nc, a->nfreqs, a->F, a->G, a->samplerate, 1.0 / (2.0 * a->size), a->ctfmode, a->wintype);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, impulse, a->nup);
 	_aligned_free (impulse);
 	return a;
 }
@@ -280,6 +280,7 @@ void SetRXAEQRun (int channel, int run)
 {
 	EnterCriticalSection (&ch[channel].csDSP);
 	rxa[channel].eqp.p->run = run;
+	RXAeqbp1Set (channel);
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
@@ -312,6 +313,20 @@ void SetRXAEQMP (int channel, int mp)
 	}
 }
 
+PORT
+void SetRXAEQNUP (int channel, int nup)
+{
+	EQP a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = rxa[channel].eqp.p;
+	if (a->nup != nup)
+	{
+		a->nup = nup;
+		setNup_fircore (a->p, a->nup);
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 PORT
 void SetRXAEQProfile (int channel, int nfreqs, double* F, double* G)
 {
@@ -455,6 +470,20 @@ void SetTXAEQMP (int channel, int mp)
 	}
 }
 
+PORT
+void SetTXAEQNUP (int channel, int nup)
+{
+	EQP a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = txa[channel].eqp.p;
+	if (a->nup != nup)
+	{
+		a->nup = nup;
+		setNup_fircore (a->p, a->nup);
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 PORT
 void SetTXAEQProfile (int channel, int nfreqs, double* F, double* G)
 {
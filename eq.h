@@ -39,6 +39,7 @@ typedef struct _eqp
 	int size;
 	int nc;
 	int mp;
+	int nup;
 	double* in;
 	double* out;
 	int nfreqs;
@@ -75,6 +76,10 @@ __declspec (dllexport) void SetTXAEQNC (int channel, int nc);
 
 __declspec (dllexport) void SetTXAEQMP (int channel, int mp);
 
+__declspec (dllexport) void SetRXAEQNUP (int channel, int nup);
+
+__declspec (dllexport) void SetTXAEQNUP (int channel, int nup);
+
 #endif
 
 
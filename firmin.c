@@ -287,10 +287,147 @@ void setFreqs_firopt (FIROPT a, double f_low, double f_high)
 ********************************************************************************************************/
 
 
+// Non-uniform partitions:  the impulse is split into segments whose partition size starts at 'size' and
+// doubles from one segment to the next, with up to FC_MAX_NFOR partitions per segment.  A segment with
+// partition size B collects P = B/size blocks of input, and its result is delivered P blocks after that,
+// so its work is spread over the P calls in between:  the forward fft in the first, 1/P of the frequency
+// bins of the products in each, and the reverse fft in the last.  The cost per sample grows with
+// log(nc/size) rather than with nc/size, and no call does more than 2 * size * FC_MAX_NFOR complex
+// multiply-adds per segment.  The segments' phases are staggered so that their large ffts fall in
+// different calls.  Delivering a period late needs a start at impulse offset d >= 2 * (B - size); the
+// output then never falls before the current block and no latency is added.
+
+#define FC_MAX_NFOR 8
+
+int plan_fircore_segs (int size, int nc, FCSEG seg)
+{
+	// returns the number of segments; also fills in 'seg' if it's not null
+	int n = 0, d = 0, b = size, rem, nfor;
+	while (d < nc)
+	{
+		rem = nc - d;
+		while (b > rem) b /= 2;
+		while (b > size && 2 * (b - size) > d) b /= 2;
+		nfor = 1;
+		while (2 * nfor <= FC_MAX_NFOR && 2 * nfor * b <= rem) nfor *= 2;
+		if (seg)
+		{
+			seg[n].size = b;
+			seg[n].offset = d;
+			seg[n].nfor = nfor;
+		}
+		n++;
+		d += nfor * b;
+		b *= 2;
+	}
+	return n;
+}
+
+static void phase_fircore_segs (FIRCORE a, int maxsize)
+{
+	// choose each segment's starting phase, largest segments first, so that the most expensive call
+	// of the longest period is as cheap as possible and, among equals, the load is the most even
+	int i, j, b, P, ph, best, tf, ti;
+	int nblk = maxsize / a->size;
+	double c, l, w, w2, bestw, bestw2;
+	double* load = (double *) malloc0 (nblk * sizeof (double));
+	FCSEG s;
+	for (b = maxsize; b >= a->size; b /= 2)
+		for (j = 0; j < a->nseg; j++)
+		{
+			s = &a->seg[j];
+			if (s->size != b) continue;
+			P = b / a->size;
+			c = 2.0 * b * log ((double)(2 * b));
+			best = 0;
+			bestw = bestw2 = 0.0;
+			for (ph = 0; ph < P; ph++)
+			{
+				// calls, mod P, that run the forward and the reverse fft
+				tf = P - 1 - ph;
+				ti = (tf + P - 1) % P;
+				w = w2 = 0.0;
+				for (i = 0; i < nblk; i++)
+				{
+					l = load[i] + ((i % P == tf) + (i % P == ti)) * c;
+					w = max (w, l);
+					w2 += l * l;
+				}
+				if (ph == 0 || w < bestw || (w == bestw && w2 < bestw2))
+				{
+					best = ph;
+					bestw = w;
+					bestw2 = w2;
+				}
+			}
+			s->phase = best;
+			tf = P - 1 - best;
+			ti = (tf + P - 1) % P;
+			for (i = 0; i < nblk; i++)
+				load[i] += ((i % P == tf) + (i % P == ti)) * c;
+		}
+	_aligned_free (load);
+}
+
+void plan_fircore_nu (FIRCORE a)
+{
+	int i, j, maxsize = a->size;
+	FCSEG s;
+	a->cset = 0;
+	a->nseg = plan_fircore_segs (a->size, a->nc, 0);
+	a->seg = (FCSEG) malloc0 (a->nseg * sizeof (fcseg));
+	plan_fircore_segs (a->size, a->nc, a->seg);
+	for (j = 0; j < a->nseg; j++)
+		if (a->seg[j].size > maxsize) maxsize = a->seg[j].size;
+	phase_fircore_segs (a, maxsize);
+	a->maskgen = (double *) malloc0 (2 * maxsize * sizeof (complex));
+	for (j = 0; j < a->nseg; j++)
+	{
+		s = &a->seg[j];
+		s->idxmask = s->nfor - 1;
+		s->buffidx = 0;
+		s->fill = s->phase;
+		s->slice = s->size / a->size;
+		s->fftin = (double *) malloc0 (2 * s->size * sizeof (complex));
+		s->fftout   = (double **) malloc0 (s->nfor * sizeof (double *));
+		s->fmask    = (double ***) malloc0 (2 * sizeof (double **));
+		s->fmask[0] = (double **) malloc0 (s->nfor * sizeof (double *));
+		s->fmask[1] = (double **) malloc0 (s->nfor * sizeof (double *));
+		s->pcfor = (fftw_plan *) malloc0 (s->nfor * sizeof (fftw_plan));
+		s->maskplan    = (fftw_plan **) malloc0 (2 * sizeof (fftw_plan *));
+		s->maskplan[0] = (fftw_plan *) malloc0 (s->nfor * sizeof (fftw_plan));
+		s->maskplan[1] = (fftw_plan *) malloc0 (s->nfor * sizeof (fftw_plan));
+		for (i = 0; i < s->nfor; i++)
+		{
+			s->fftout[i]   = (double *) malloc0 (2 * s->size * sizeof (complex));
+			s->fmask[0][i] = (double *) malloc0 (2 * s->size * sizeof (complex));
+			s->fmask[1][i] = (double *) malloc0 (2 * s->size * sizeof (complex));
+			s->pcfor[i] = fftw_plan_dft_1d(2 * s->size, (fftw_complex *)s->fftin, (fftw_complex *)s->fftout[i], FFTW_FORWARD, FFTW_PATIENT);
+			s->maskplan[0][i] = fftw_plan_dft_1d(2 * s->size, (fftw_complex *)a->maskgen, (fftw_complex *)s->fmask[0][i], FFTW_FORWARD, FFTW_PATIENT);
+			s->maskplan[1][i] = fftw_plan_dft_1d(2 * s->size, (fftw_complex *)a->maskgen, (fftw_complex *)s->fmask[1][i], FFTW_FORWARD, FFTW_PATIENT);
+		}
+		s->accum = (double *) malloc0 (2 * s->size * sizeof (complex));
+		s->tout  = (double *) malloc0 (2 * s->size * sizeof (complex));
+		s->crev = fftw_plan_dft_1d(2 * s->size, (fftw_complex *)s->accum, (fftw_complex *)s->tout, FFTW_BACKWARD, FFTW_PATIENT);
+	}
+	// a segment's output reaches at most 'offset + size' <= 'nc' samples past the start of the current block;
+	// the ring is a power of two so that indices wrap with a mask
+	for (j = a->size; j < 2 * a->nc; j *= 2);
+	a->ola = (double *) malloc0 (j * sizeof (complex));
+	a->olamask = j - 1;
+	a->olaidx = 0;
+	a->masks_ready = 0;
+}
+
 void plan_fircore (FIRCORE a)
 {
 	// must call for change in 'nc', 'size', 'out'
 	int i;
+	if (a->nup)
+	{
+		plan_fircore_nu (a);
+		return;
+	}
 	a->nfor = a->nc / a->size;
 	a->cset = 0;
 	a->buffidx = 0;
@@ -319,6 +456,47 @@ void plan_fircore (FIRCORE a)
 	a->masks_ready = 0;
 }
 
+void calc_fircore_nu (FIRCORE a)
+{
+	// the impulse is scaled for a 2*size fft; rescale for each segment's 2*seg.size fft
+	int i, j, k;
+	double scale;
+	double* mask;
+	FCSEG s;
+	for (j = 0; j < a->nseg; j++)
+	{
+		s = &a->seg[j];
+		scale = (double)a->size / (double)s->size;
+		for (i = 0; i < s->nfor; i++)
+		{
+			memset (a->maskgen, 0, s->size * sizeof (complex));
+			memcpy (&(a->maskgen[2 * s->size]), &(a->imp[2 * (s->offset + i * s->size)]), s->size * sizeof(complex));
+			fftw_execute (s->maskplan[1 - a->cset][i]);
+			mask = s->fmask[1 - a->cset][i];
+			if (scale != 1.0)
+				for (k = 0; k < 4 * s->size; k++)
+					mask[k] *= scale;
+		}
+	}
+}
+
+void flip_fircore (FIRCORE a)
+{
+	// Publish the masks just calculated.  The DSP thread picks up the new set at its next block and is
+	// never blocked; this thread waits, at most one block, until the old set is out of use so that
+	// the next calc_fircore() can overwrite it.
+	LONG sync;
+	EnterCriticalSection (&a->update);
+	WriteRelease (&a->cset, 1 - a->cset);
+	MemoryBarrier ();
+	sync = ReadAcquire (&a->rsync);
+	if (sync & 1)
+		while (ReadAcquire (&a->rsync) == sync)
+			Sleep (0);
+	LeaveCriticalSection (&a->update);
+	a->masks_ready = 0;
+}
+
 void calc_fircore (FIRCORE a, int flip)
 {
 	// call for change in frequency, rate, wintype, gain
@@ -328,24 +506,24 @@ void calc_fircore (FIRCORE a, int flip)
 		mp_imp (a->nc, a->impulse, a->imp, 16, 0);
 	else
 		memcpy (a->imp, a->impulse, a->nc * sizeof (complex));
-	for (i = 0; i < a->nfor; i++)
-	{
-		// I right-justified the impulse response => take output from left side of output buff, discard right side
-		// Be careful about flipping an asymmetrical impulse response.
-		memcpy (&(a->maskgen[2 * a->size]), &(a->imp[2 * a->size * i]), a->size * sizeof(complex));
-		fftw_execute (a->maskplan[1 - a->cset][i]);
-	}
+	if (a->nup)
+		calc_fircore_nu (a);
+	else
+		for (i = 0; i < a->nfor; i++)
+		{
+			// I right-justified the impulse response => take output from left side of output buff, discard right side
+			// Be careful about flipping an asymmetrical impulse response.
+			memcpy (&(a->maskgen[2 * a->size]), &(a->imp[2 * a->size * i]), a->size * sizeof(complex));
+			fftw_execute (a->maskplan[1 - a->cset][i]);
+		}
 	a->masks_ready = 1;
 	if (flip)
-	{
-		EnterCriticalSection (&a->update);
-		a->cset = 1 - a->cset;
-		LeaveCriticalSection (&a->update);
-		a->masks_ready = 0;
-	}
+		flip_fircore (a);
+	if (a->fuse)
+		calc_fcfuse (a->fuse, flip);
 }
 
-FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, double* impulse)
+FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, double* impulse, int nup)
 {
 	FIRCORE a = (FIRCORE) malloc0 (sizeof (fircore));
 	a->size = size;
@@ -353,6 +531,7 @@ FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, doubl
 	a->out = out;
 	a->nc = nc;
 	a->mp = mp;
+	a->nup = nup;
 	InitializeCriticalSectionAndSpinCount (&a->update, 2500);
 	plan_fircore (a);
 	a->impulse = (double *) malloc0 (a->nc * sizeof (complex));
@@ -362,9 +541,48 @@ FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, doubl
 	return a;
 }
 
+void deplan_fircore_nu (FIRCORE a)
+{
+	int i, j;
+	FCSEG s;
+	_aligned_free (a->ola);
+	for (j = 0; j < a->nseg; j++)
+	{
+		s = &a->seg[j];
+		fftw_destroy_plan (s->crev);
+		_aligned_free (s->tout);
+		_aligned_free (s->accum);
+		for (i = 0; i < s->nfor; i++)
+		{
+			_aligned_free (s->fftout[i]);
+			_aligned_free (s->fmask[0][i]);
+			_aligned_free (s->fmask[1][i]);
+			fftw_destroy_plan (s->pcfor[i]);
+			fftw_destroy_plan (s->maskplan[0][i]);
+			fftw_destroy_plan (s->maskplan[1][i]);
+		}
+		_aligned_free (s->maskplan[0]);
+		_aligned_free (s->maskplan[1]);
+		_aligned_free (s->maskplan);
+		_aligned_free (s->pcfor);
+		_aligned_free (s->fmask[0]);
+		_aligned_free (s->fmask[1]);
+		_aligned_free (s->fmask);
+		_aligned_free (s->fftout);
+		_aligned_free (s->fftin);
+	}
+	_aligned_free (a->maskgen);
+	_aligned_free (a->seg);
+}
+
 void deplan_fircore (FIRCORE a)
 {
 	int i;
+	if (a->nup)
+	{
+		deplan_fircore_nu (a);
+		return;
+	}
 	fftw_destroy_plan (a->crev);
 	_aligned_free (a->accum);
 	for (i = 0; i < a->nfor; i++)
@@ -399,40 +617,125 @@ void destroy_fircore (FIRCORE a)
 
 void flush_fircore (FIRCORE a)
 {
-	int i; 
+	int i, j;
+	FCSEG s;
+	if (a->nup)
+	{
+		for (j = 0; j < a->nseg; j++)
+		{
+			s = &a->seg[j];
+			memset (s->fftin, 0, 2 * s->size * sizeof (complex));
+			for (i = 0; i < s->nfor; i++)
+				memset (s->fftout[i], 0, 2 * s->size * sizeof (complex));
+			s->buffidx = 0;
+			s->fill = s->phase;
+			s->slice = s->size / a->size;
+		}
+		memset (a->ola, 0, (a->olamask + 1) * sizeof (complex));
+		a->olaidx = 0;
+		return;
+	}
 	memset (a->fftin, 0, 2 * a->size * sizeof (complex));
 	for (i = 0; i < a->nfor; i++)
 		memset (a->fftout[i], 0, 2 * a->size * sizeof (complex));
 	a->buffidx = 0;
 }
 
+void xfircore_nu (FIRCORE a)
+{
+	int i, j, k, n;
+	int cset, ostart, P, off;
+	LONG sync;
+	FCSEG s;
+	double* tout;
+	double* ola = a->ola;
+	int olamask = a->olamask;
+	int sz = a->size;
+	sync = InterlockedIncrement (&a->rsync);
+	cset = ReadAcquire (&a->cset);
+	for (n = 0; n < a->nseg; n++)
+	{
+		s = &a->seg[n];
+		P = s->size / sz;
+		memcpy (&(s->fftin[2 * (s->size + s->fill * sz)]), a->in, sz * sizeof (complex));
+		if (++s->fill == P)
+		{
+			// a full partition of new input; the previous partition's work finished in the last call
+			s->fill = 0;
+			fftw_execute (s->pcfor[s->buffidx]);
+			memcpy (s->fftin, &(s->fftin[2 * s->size]), s->size * sizeof (complex));
+			s->newidx = s->buffidx;
+			s->buffidx = (s->buffidx + 1) & s->idxmask;
+			s->slice = 0;
+		}
+		if (s->slice == P)
+			continue;
+		// this call's share of the products:  2 * sz of the 2 * s->size bins.  A mask change between
+		// calls of a period applies to the remaining bins only, for that one partition.
+		off = 4 * sz * s->slice;
+		k = s->newidx;
+		cmul (s->accum + off, s->fftout[k] + off, s->fmask[cset][0] + off, 2 * sz);
+		for (j = 1; j < s->nfor; j++)
+		{
+			k = (k + s->idxmask) & s->idxmask;
+			cmac (s->accum + off, s->fftout[k] + off, s->fmask[cset][j] + off, 2 * sz);
+		}
+		if (++s->slice < P)
+			continue;
+		fftw_execute (s->crev);
+		// the partition ended P - 1 calls ago; its output starts 'offset - 2 * (size - sz)' samples
+		// after the start of the current block
+		tout = s->tout;
+		ostart = a->olaidx + s->offset - 2 * (s->size - sz);
+		for (i = 0; i < s->size; i++)
+		{
+			k = (ostart + i) & olamask;
+			ola[2 * k + 0] += tout[2 * i + 0];
+			ola[2 * k + 1] += tout[2 * i + 1];
+		}
+	}
+	WriteRelease (&a->rsync, sync + 1);
+	// 'olaidx' is a multiple of 'size' and the ring is a multiple of 'size' long, so the block is contiguous
+	memcpy (a->out, &(ola[2 * a->olaidx]), sz * sizeof (complex));
+	memset (&(ola[2 * a->olaidx]), 0, sz * sizeof (complex));
+	a->olaidx = (a->olaidx + sz) & olamask;
+}
+
 void xfircore (FIRCORE a)
 {
 	//[2.10.3.9]MW0LGE refactor to remove pointer chase in the loops
-	int i, j, k;
+	int j, k;
+	if (a->fuse && a->fuse->run && a->fuse->ok)
+	{
+		// the first filter of a fused pair runs the composite, the second is idle
+		if (a == a->fuse->a)
+			xfircore (a->fuse->p);
+		return;
+	}
+	if (a->nup)
+	{
+		xfircore_nu (a);
+		return;
+	}
 	memcpy (&(a->fftin[2 * a->size]), a->in, a->size * sizeof (complex));
 	fftw_execute (a->pcfor[a->buffidx]);
 	k = a->buffidx;
-	memset (a->accum, 0, 2 * a->size * sizeof (complex));
-	EnterCriticalSection (&a->update);
+	LONG sync = InterlockedIncrement (&a->rsync);
 	double* accum = a->accum;
 	double** fftout = a->fftout;
-	double*** fmask = a->fmask;
-	int cset = a->cset;
-	int idxmask = a->idxmask;
+	double** fmask = a->fmask[ReadAcquire (&a->cset)];
 	int sz = a->size;
 	int nfor = a->nfor;
-	for (j = 0; j < nfor; j++)
+	// the first partition initializes 'accum', the rest accumulate into it; 'nfor' need not be a power
+	// of two, so the delay line index wraps by comparison
+	cmul (accum, fftout[k], fmask[0], 2 * sz);
+	for (j = 1; j < nfor; j++)
 	{
-		for (i = 0; i < 2 * sz; i++)
-		{
-			accum[2 * i + 0] += fftout[k][2 * i + 0] * fmask[cset][j][2 * i + 0] - fftout[k][2 * i + 1] * fmask[cset][j][2 * i + 1];
-			accum[2 * i + 1] += fftout[k][2 * i + 0] * fmask[cset][j][2 * i + 1] + fftout[k][2 * i + 1] * fmask[cset][j][2 * i + 0];
-		}
-		k = (k + idxmask) & idxmask;
+		if (--k < 0) k = nfor - 1;
+		cmac (accum, fftout[k], fmask[j], 2 * sz);
 	}
-	LeaveCriticalSection (&a->update);
-	a->buffidx = (a->buffidx + 1) & idxmask;
+	WriteRelease (&a->rsync, sync + 1);
+	if (++a->buffidx == nfor) a->buffidx = 0;
 	fftw_execute (a->crev);
 	memcpy (a->fftin, &(a->fftin[2 * a->size]), a->size * sizeof(complex));
 }
@@ -483,10 +786,142 @@ void setMp_fircore (FIRCORE a, int mp)
 void setUpdate_fircore (FIRCORE a)
 {
 	if (a->masks_ready)
+		flip_fircore (a);
+	if (a->fuse && a->fuse->run && a->fuse->p)
+		setUpdate_fircore (a->fuse->p);
+}
+
+void setNup_fircore (FIRCORE a, int nup)
+{
+	// because of FFT planning, this will probably cause a glitch in audio if done during dataflow
+	deplan_fircore (a);
+	a->nup = nup;
+	plan_fircore (a);
+	calc_fircore (a, 1);
+}
+
+/********************************************************************************************************
+*																										*
+*											Fused Filter Pair											*
+*																										*
+********************************************************************************************************/
+
+// Two filters that run one after the other, in place on the same buffer, with nothing between them can be
+// replaced by one filter whose impulse is the convolution of theirs.  That halves the fft work; the
+// multiply-accumulate work is unchanged.  The owner of the pair decides, with the DSP thread excluded,
+// when it is fused; all changes to 'a' or 'b' are passed on to the composite while it is.
+
+void plan_fcfuse (FCFUSE f, int nc)
+{
+	f->nc = nc;
+	f->fa  = (double *) malloc0 (f->nc * sizeof (complex));
+	f->fb  = (double *) malloc0 (f->nc * sizeof (complex));
+	f->imp = (double *) malloc0 (f->nc * sizeof (complex));
+	f->pa   = fftw_plan_dft_1d (f->nc, (fftw_complex *)f->fa, (fftw_complex *)f->fa, FFTW_FORWARD, FFTW_ESTIMATE);
+	f->pb   = fftw_plan_dft_1d (f->nc, (fftw_complex *)f->fb, (fftw_complex *)f->fb, FFTW_FORWARD, FFTW_ESTIMATE);
+	f->prev = fftw_plan_dft_1d (f->nc, (fftw_complex *)f->fa, (fftw_complex *)f->imp, FFTW_BACKWARD, FFTW_ESTIMATE);
+}
+
+void deplan_fcfuse (FCFUSE f)
+{
+	if (f->nc == 0) return;
+	fftw_destroy_plan (f->prev);
+	fftw_destroy_plan (f->pb);
+	fftw_destroy_plan (f->pa);
+	_aligned_free (f->imp);
+	_aligned_free (f->fb);
+	_aligned_free (f->fa);
+	f->nc = 0;
+}
+
+FCFUSE create_fcfuse (FIRCORE a, FIRCORE b)
+{
+	FCFUSE f = (FCFUSE) malloc0 (sizeof (fcfuse));
+	f->a = a;
+	f->b = b;
+	a->fuse = f;
+	b->fuse = f;
+	return f;
+}
+
+void destroy_fcfuse (FCFUSE f)
+{
+	f->a->fuse = 0;
+	f->b->fuse = 0;
+	if (f->p) destroy_fircore (f->p);
+	deplan_fcfuse (f);
+	_aligned_free (f);
+}
+
+void flush_fcfuse (FCFUSE f)
+{
+	if (f->p) flush_fircore (f->p);
+}
+
+void calc_fcfuse (FCFUSE f, int flip)
+{
+	// called from calc_fircore() of either filter
+	FIRCORE a = f->a;
+	FIRCORE b = f->b;
+	int i, nc;
+	double scale;
+	if (!(a->size == b->size && a->nup == b->nup &&
+		a->in == a->out && b->in == a->out && b->out == a->out))
+	{
+		f->ok = 0;
+		return;
+	}
+	if (!f->run) return;
+	// the linear convolution of the two impulses, rounded up to whole partitions
+	nc = a->nc + b->nc - 1;
+	nc = ((nc + a->size - 1) / a->size) * a->size;
+	if (nc != f->nc)
+	{
+		deplan_fcfuse (f);
+		plan_fcfuse (f, nc);
+	}
+	memset (f->fa, 0, f->nc * sizeof (complex));
+	memset (f->fb, 0, f->nc * sizeof (complex));
+	// convolve the impulses the filters actually apply, minimum phase already applied where selected;
+	// the composite is then the cascade itself and is used as is
+	memcpy (f->fa, a->imp, a->nc * sizeof (complex));
+	memcpy (f->fb, b->imp, b->nc * sizeof (complex));
+	fftw_execute (f->pa);
+	fftw_execute (f->pb);
+	cmul (f->fa, f->fa, f->fb, f->nc);
+	fftw_execute (f->prev);
+	// each impulse carries a 1/(2*size) scale for its own fft round trip; the composite needs only one
+	scale = 2.0 * (double)a->size / (double)f->nc;
+	for (i = 0; i < 2 * f->nc; i++)
+		f->imp[i] *= scale;
+	if (!f->p)
+		f->p = create_fircore (a->size, a->out, a->out, f->nc, 0, f->imp, a->nup);
+	else
+	{
+		if (f->p->nup != a->nup) setNup_fircore (f->p, a->nup);
+		if (f->p->size != a->size) setSize_fircore (f->p, a->size);
+		if (f->p->in != a->out || f->p->out != a->out) setBuffers_fircore (f->p, a->out, a->out);
+		if (f->p->nc != f->nc)
+			setNc_fircore (f->p, f->nc, f->imp);
+		else
+			setImpulse_fircore (f->p, f->imp, flip);
+	}
+	f->ok = 1;
+}
+
+void setRun_fcfuse (FCFUSE f, int run)
+{
+	// call with the DSP thread excluded; each side starts from a flushed history
+	if (f->run == run) return;
+	f->run = run;
+	if (f->run)
+	{
+		calc_fcfuse (f, 1);
+		flush_fcfuse (f);
+	}
+	else
 	{
-		EnterCriticalSection (&a->update);
-		a->cset = 1 - a->cset;
-		LeaveCriticalSection (&a->update);
-		a->masks_ready = 0;
+		flush_fircore (f->a);
+		flush_fircore (f->b);
 	}
 }
@@ -135,12 +135,33 @@ extern void setFreqs_firopt (FIROPT a, double f_low, double f_high);
 #ifndef _fircore_h
 #define _fircore_h
 
+typedef struct _fcseg
+{
+	int size;				// partition size for this segment, power of two, multiple of the fircore 'size'
+	int offset;				// index of the first impulse coefficient covered by this segment
+	int nfor;				// number of partitions in this segment, power of two
+	int idxmask;			// mask for index computations
+	int buffidx;			// fft out buffer index
+	int newidx;				// fft out buffer of the partition whose products are being formed
+	int fill;				// number of fircore-size input blocks collected toward the next fft
+	int phase;				// value of 'fill' after a flush; staggers the segments' ffts
+	int slice;				// next share of the products to form; size / fircore size when none is pending
+	double* fftin;			// fft input buffer
+	double*** fmask;		// frequency domain masks
+	double** fftout;		// fftout delay line
+	double* accum;			// frequency domain accumulator
+	double* tout;			// time domain result of the reverse fft
+	fftw_plan* pcfor;		// array of forward FFT plans
+	fftw_plan crev;			// reverse fft plan
+	fftw_plan** maskplan;	// plans for frequency domain masks
+} fcseg, *FCSEG;
+
 typedef struct _fircore
 {
 	int size;				// input/output buffer size, power of two
 	double* in;				// input buffer
 	double* out;			// output buffer, can be same as input
-	int nc;					// number of filter coefficients, power of two, >= size
+	int nc;					// number of filter coefficients, multiple of size
 	double* impulse;		// impulse response of filter
 	double* imp;
 	int nfor;				// number of buffers in delay line
@@ -154,14 +175,22 @@ typedef struct _fircore
 	fftw_plan* pcfor;		// array of forward FFT plans
 	fftw_plan crev;			// reverse fft plan
 	fftw_plan** maskplan;	// plans for frequency domain masks
-	CRITICAL_SECTION update;
-	int cset;
+	CRITICAL_SECTION update;	// serializes mask publication by control threads; never taken by xfircore()
+	volatile LONG cset;		// mask set in use, published with release semantics
+	volatile LONG rsync;	// incremented by xfircore() on entry and exit; odd while it uses masks 'cset'
 	int mp;
 	int masks_ready;
+	int nup;				// 1 for non-uniform partitions, 0 for uniform partitions of 'size'
+	int nseg;				// non-uniform:  number of segments
+	FCSEG seg;				// non-uniform:  segments, partition size growing along the impulse
+	double* ola;			// non-uniform:  output accumulation ring
+	int olamask;			// non-uniform:  mask for output ring index computations
+	int olaidx;				// non-uniform:  output ring index of the current block
+	struct _fcfuse* fuse;	// fused pair this filter belongs to, if any
 } fircore, *FIRCORE;
 
 extern FIRCORE create_fircore (int size, double* in, double* out, 
-	int nc, int mp, double* impulse);
+	int nc, int mp, double* impulse, int nup);
 
 extern void xfircore (FIRCORE a);
 
@@ -181,4 +210,38 @@ extern void setMp_fircore (FIRCORE a, int mp);
 
 extern void setUpdate_fircore (FIRCORE a);
 
+extern void setNup_fircore (FIRCORE a, int nup);
+
+/********************************************************************************************************
+*																										*
+*											Fused Filter Pair											*
+*																										*
+********************************************************************************************************/
+
+typedef struct _fcfuse
+{
+	int run;				// 1 to run the composite in place of 'a' followed by 'b'
+	int ok;					// 1 if 'a' and 'b' are compatible:  same size, partitioning, buffer
+	FIRCORE a;				// first filter; its xfircore() runs the composite when fused
+	FIRCORE b;				// second filter; its xfircore() does nothing when fused
+	FIRCORE p;				// composite filter
+	int nc;					// composite impulse length, a->nc + b->nc - 1 rounded up to a multiple of size
+	double* fa;				// spectrum of a's impulse
+	double* fb;				// spectrum of b's impulse
+	double* imp;			// composite impulse
+	fftw_plan pa;
+	fftw_plan pb;
+	fftw_plan prev;
+} fcfuse, *FCFUSE;
+
+extern FCFUSE create_fcfuse (FIRCORE a, FIRCORE b);
+
+extern void destroy_fcfuse (FCFUSE f);
+
+extern void flush_fcfuse (FCFUSE f);
+
+extern void calc_fcfuse (FCFUSE f, int flip);
+
+extern void setRun_fcfuse (FCFUSE f, int run);
+
 #endif
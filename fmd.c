@@ -104,17 +104,18 @@ FMD create_fmd( int run, int size, double* in, double* out, int rate, double dev
 	a->nc_aud = nc_aud;
 	a->mp_aud = mp_aud;
 	a->lim_run = 0;
+	a->mode = FMD_PLL;
 	a->lim_pre_gain = 0.4;
 	a->lim_gain = 2.5;
 	calc_fmd (a);
 	// de-emphasis filter
 	a->audio = (double *) malloc0 (a->size * sizeof (complex));
 	impulse = fc_impulse (a->nc_de, a->f_low, a->f_high, +20.0 * log10(a->f_high / a->f_low), 0.0, 1, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse);
+	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse, 0);
 	_aligned_free (impulse);
 	// audio filter
 	impulse = fir_bandpass(a->nc_aud, 0.8 * a->f_low, 1.1 * a->f_high, a->rate, 0, 1, a->afgain / (2.0 * a->size));
-	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse);
+	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse, 0);
 	_aligned_free (impulse);
 	return a;
 }
@@ -137,10 +138,29 @@ void flush_fmd (FMD a)
 	a->fil_out = 0.0;
 	a->omega = 0.0;
 	a->fmdc = 0.0;
+	a->last[0] = 0.0;
+	a->last[1] = 0.0;
 	flush_snotch (a->sntch);
 	flush_wcpagc (a->plim);
 }
 
+// atan2 for the polar discriminator:  Abramowitz & Stegun 4.4.49 on the octant-reduced ratio, with
+// |error| < 4e-8 radians.  Written with selects rather than branches so the calling loop vectorizes.
+static __inline double fmd_atan2 (double y, double x)
+{
+	double ax = fabs (x);
+	double ay = fabs (y);
+	double mx = ax > ay ? ax : ay;
+	double mn = ax > ay ? ay : ax;
+	double t = mn / (mx > 0.0 ? mx : 1.0);
+	double t2 = t * t;
+	double r = t * (0.9999993329 + t2 * (-0.3332985605 + t2 * (0.1994653599 + t2 * (-0.1390853351
+		+ t2 * (0.0964200441 + t2 * (-0.0559098861 + t2 * (0.0218612288 + t2 * (-0.0040540580))))))));
+	r = ay > ax ? 0.5 * PI - r : r;
+	r = x < 0.0 ? PI - r : r;
+	return y < 0.0 ? -r : r;
+}
+
 void xfmd (FMD a)
 {
 	if (a->run)
@@ -148,27 +168,53 @@ void xfmd (FMD a)
 		int i;
 		double det, del_out;
 		double vco[2], corr[2];
-		for (i = 0; i < a->size; i++)
+		if (a->mode == FMD_POLAR)
 		{
-			// pll
-			vco[0]  = cos (a->phs);
-			vco[1]  = sin (a->phs);
-			corr[0] = + a->in[2 * i + 0] * vco[0] + a->in[2 * i + 1] * vco[1];
-			corr[1] = - a->in[2 * i + 0] * vco[1] + a->in[2 * i + 1] * vco[0];
-			if ((corr[0] == 0.0) && (corr[1] == 0.0)) corr[0] = 1.0;
-			det = atan2 (corr[1], corr[0]);
-			del_out = a->fil_out;
-			a->omega += a->g2 * det;
-			if (a->omega < a->omega_min) a->omega = a->omega_min;
-			if (a->omega > a->omega_max) a->omega = a->omega_max;
-			a->fil_out = a->g1 * det + a->omega;
-			a->phs += del_out;
-			while (a->phs >= TWOPI) a->phs -= TWOPI;
-			while (a->phs < 0.0) a->phs += TWOPI;
+			// discriminator:  the phase step arg (x[i] * conj (x[i-1])) is the frequency in rad/sample
+			double* in = a->in;
+			double* aud = a->audio;
+			aud[0] = in[0] * a->last[0] + in[1] * a->last[1];
+			aud[1] = in[1] * a->last[0] - in[0] * a->last[1];
+			for (i = 1; i < a->size; i++)
+			{
+				aud[2 * i + 0] = in[2 * i + 1] * in[2 * i - 1] + in[2 * i + 0] * in[2 * i - 2];
+				aud[2 * i + 1] = in[2 * i + 1] * in[2 * i - 2] - in[2 * i + 0] * in[2 * i - 1];
+			}
+			a->last[0] = in[2 * (a->size - 1) + 0];
+			a->last[1] = in[2 * (a->size - 1) + 1];
+			for (i = 0; i < a->size; i++)
+				aud[2 * i + 0] = fmd_atan2 (aud[2 * i + 1], aud[2 * i + 0]);
 			// dc removal, gain, & demod output
-			a->fmdc = a->mtau * a->fmdc + a->onem_mtau * a->fil_out;
-			a->audio[2 * i + 0] = a->again * (a->fil_out - a->fmdc);
-			a->audio[2 * i + 1] = a->audio[2 * i + 0];
+			for (i = 0; i < a->size; i++)
+			{
+				a->fmdc = a->mtau * a->fmdc + a->onem_mtau * aud[2 * i + 0];
+				aud[2 * i + 0] = a->again * (aud[2 * i + 0] - a->fmdc);
+				aud[2 * i + 1] = aud[2 * i + 0];
+			}
+		}
+		else
+		{
+			for (i = 0; i < a->size; i++)
+			{
+				// pll
+				nco_sincos (a->phs, &vco[0], &vco[1]);
+				corr[0] = + a->in[2 * i + 0] * vco[0] + a->in[2 * i + 1] * vco[1];
+				corr[1] = - a->in[2 * i + 0] * vco[1] + a->in[2 * i + 1] * vco[0];
+				if ((corr[0] == 0.0) && (corr[1] == 0.0)) corr[0] = 1.0;
+				det = atan2 (corr[1], corr[0]);
+				del_out = a->fil_out;
+				a->omega += a->g2 * det;
+				if (a->omega < a->omega_min) a->omega = a->omega_min;
+				if (a->omega > a->omega_max) a->omega = a->omega_max;
+				a->fil_out = a->g1 * det + a->omega;
+				a->phs += del_out;
+				while (a->phs >= TWOPI) a->phs -= TWOPI;
+				while (a->phs < 0.0) a->phs += TWOPI;
+				// dc removal, gain, & demod output
+				a->fmdc = a->mtau * a->fmdc + a->onem_mtau * a->fil_out;
+				a->audio[2 * i + 0] = a->again * (a->fil_out - a->fmdc);
+				a->audio[2 * i + 1] = a->audio[2 * i + 0];
+			}
 		}
 		// de-emphasis
 		xfircore (a->pde);
@@ -226,12 +272,12 @@ void setSize_fmd (FMD a, int size)
 	// de-emphasis filter
 	destroy_fircore (a->pde);
 	impulse = fc_impulse (a->nc_de, a->f_low, a->f_high, +20.0 * log10(a->f_high / a->f_low), 0.0, 1, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse);
+	a->pde = create_fircore (a->size, a->audio, a->out, a->nc_de, a->mp_de, impulse, 0);
 	_aligned_free (impulse);
 	// audio filter
 	destroy_fircore (a->paud);
 	impulse = fir_bandpass(a->nc_aud, 0.8 * a->f_low, 1.1 * a->f_high, a->rate, 0, 1, a->afgain / (2.0 * a->size));
-	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse);
+	a->paud = create_fircore (a->size, a->out, a->out, a->nc_aud, a->mp_aud, impulse, 0);
 	_aligned_free (impulse);
 	setSize_wcpagc (a->plim, a->size);
 }
@@ -333,6 +379,24 @@ void SetRXAFMMPaud (int channel, int mp)
 	}
 }
 
+PORT
+void SetRXAFMDetectorMode (int channel, int mode)
+{
+	FMD a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = rxa[channel].fmd.p;
+	if (a->mode != mode)
+	{
+		a->mode = mode;
+		a->phs = 0.0;
+		a->fil_out = 0.0;
+		a->omega = 0.0;
+		a->last[0] = 0.0;
+		a->last[1] = 0.0;
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 PORT
 void SetRXAFMLimRun (int channel, int run)
 {
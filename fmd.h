@@ -29,6 +29,9 @@ warren@wpratt.com
 #include "iir.h"
 #include "firmin.h"
 #include "wcpAGC.h"
+#define FMD_PLL		0				// phase-locked loop detector
+#define FMD_POLAR	1				// conjugate-product discriminator
+
 typedef struct _fmd
 {
 	int run;
@@ -38,6 +41,8 @@ typedef struct _fmd
 	double rate;
 	double f_low;						// audio low cutoff
 	double f_high;						// audio high cutoff
+	int mode;							// FMD_PLL or FMD_POLAR
+	double last[2];						// polar - previous input sample
 	// pll
 	double fmin;						// pll - minimum carrier freq to lock
 	double fmax;						// pll - maximum carrier freq to lock
@@ -107,4 +112,6 @@ extern __declspec (dllexport) void SetRXAFMNCaud (int channel, int nc);
 
 extern __declspec (dllexport) void SetRXAFMMPaud (int channel, int mp);
 
+extern __declspec (dllexport) void SetRXAFMDetectorMode (int channel, int mode);
+
 #endif
@@ -60,7 +60,7 @@ FMMOD create_fmmod (int run, int size, double* in, double* out, int rate, double
 	a->mp = mp;
 	calc_fmmod (a);
 	impulse = fir_bandpass(a->nc, -a->bp_fc, +a->bp_fc, a->samplerate, 0, 1, 1.0 / (2 * a->size));
-	a->p = create_fircore (a->size, a->out, a->out, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->out, a->out, a->nc, a->mp, impulse, 0);
 	_aligned_free (impulse);
 	return a;
 }
@@ -80,7 +80,7 @@ void flush_fmmod (FMMOD a)
 void xfmmod (FMMOD a)
 {
 	int i;
-	double dp, magdp, peak;
+	double dp, magdp, peak, c, s;
 	if (a->run)
 	{
 		peak = 0.0;
@@ -90,14 +90,16 @@ void xfmmod (FMMOD a)
 			{
 				a->tphase += a->tdelta;
 				if (a->tphase >= TWOPI) a->tphase -= TWOPI;
-				a->out[2 * i + 0] = a->tscale * (a->in[2 * i + 0] + a->ctcss_level * cos (a->tphase));
+				nco_sincos (a->tphase, &c, &s);
+				a->out[2 * i + 0] = a->tscale * (a->in[2 * i + 0] + a->ctcss_level * c);
 			}
 			dp = a->out[2 * i + 0] * a->sdelta;
 			a->sphase += dp;
 			if (a->sphase >= TWOPI) a->sphase -= TWOPI;
 			if (a->sphase <   0.0 ) a->sphase += TWOPI;
-			a->out[2 * i + 0] = 0.7071 * cos (a->sphase);
-			a->out[2 * i + 1] = 0.7071 * sin (a->sphase);
+			nco_sincos (a->sphase, &c, &s);
+			a->out[2 * i + 0] = 0.7071 * c;
+			a->out[2 * i + 1] = 0.7071 * s;
 			if ((magdp = dp) < 0.0) magdp = - magdp;
 			if (magdp > peak) peak = magdp;
 		}
@@ -42,7 +42,7 @@ void calc_fmsq (FMSQ a)
 	a->G[2] = 3.0;
 	a->G[3] = +20.0 * log10(20000.0 / *a->pllpole);
 	impulse = eq_impulse (a->nc, 3, a->F, a->G, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-	a->p = create_fircore (a->size, a->trigger, a->noise, a->nc, a->mp, impulse);
+	a->p = create_fircore (a->size, a->trigger, a->noise, a->nc, a->mp, impulse, 0);
 	_aligned_free (impulse);
 	// noise averaging
 	a->avm = exp(-1.0 / (a->rate * a->avtau));
@@ -28,22 +28,16 @@ warren@wpratt.com
 
 void calc_tone (GEN a)
 {
-	a->tone.phs = 0.0;
 	a->tone.delta = TWOPI * a->tone.freq / a->rate;
-	a->tone.cosdelta = cos (a->tone.delta);
-	a->tone.sindelta = sin (a->tone.delta);
+	set_nco (&a->tone.osc, 0.0, -a->tone.delta);
 }
 
 void calc_tt (GEN a)
 {
-	a->tt.phs1 = 0.0;
-	a->tt.phs2 = 0.0;
 	a->tt.delta1 = TWOPI * a->tt.f1 / a->rate;
 	a->tt.delta2 = TWOPI * a->tt.f2 / a->rate;
-	a->tt.cosdelta1 = cos (a->tt.delta1);
-	a->tt.cosdelta2 = cos (a->tt.delta2);
-	a->tt.sindelta1 = sin (a->tt.delta1);
-	a->tt.sindelta2 = sin (a->tt.delta2);
+	set_nco (&a->tt.osc1, 0.0, -a->tt.delta1);
+	set_nco (&a->tt.osc2, 0.0, -a->tt.delta2);
 }
 
 void calc_sweep (GEN a)
@@ -141,6 +135,77 @@ void decalc_gen (GEN a)
 	_aligned_free (a->pulse.ctrans);
 }
 
+/********************************************************************************************************
+*																										*
+*											Noise Source												*
+*																										*
+********************************************************************************************************/
+
+// Each generator owns a xoshiro256+ state, so channels running noise concurrently share nothing.
+// The state is expanded from the 32-bit seed with splitmix64; an unseeded generator mixes the clock
+// with its own address so that instances created in the same second still differ.
+
+static uint64_t splitmix (uint64_t* x)
+{
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static void seed_noise (GEN a)
+{
+	int i;
+	uint64_t x;
+	if (a->noise.seed)
+		x = (uint64_t)a->noise.seed;
+	else
+		x = (uint64_t)time (0) ^ ((uint64_t)(uintptr_t)a << 16);
+	for (i = 0; i < 4; i++)
+		a->noise.s[i] = splitmix (&x);
+}
+
+static __inline uint64_t rotl (uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+static __inline uint64_t xoshiro (uint64_t* s)
+{
+	uint64_t result = s[0] + s[3];
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl (s[3], 45);
+	return result;
+}
+
+// Fills 'out' with 'n' complex samples whose real and imaginary parts are independent N(0, mag^2).
+// Box-Muller, one uniform pair per complex sample:  the uniforms for a span are drawn first so the
+// transform loop has no rejection branch and no dependence on the generator state.
+static void xnoise (GEN a, int n, double* out)
+{
+	int i, j, m;
+	double c, s, rad;
+	double u[2 * NCO_SPAN];
+	for (j = 0; j < n; j += NCO_SPAN)
+	{
+		m = min (NCO_SPAN, n - j);
+		for (i = 0; i < 2 * m; i++)
+			u[i] = (double)(xoshiro (a->noise.s) >> 11) * (1.0 / 9007199254740992.0);
+		for (i = 0; i < m; i++)
+		{
+			rad = a->noise.mag * sqrt (-2.0 * log (1.0 - u[2 * i + 0]));
+			nco_sincos (TWOPI * u[2 * i + 1], &c, &s);
+			out[2 * (j + i) + 0] = rad * c;
+			out[2 * (j + i) + 1] = rad * s;
+		}
+	}
+}
+
 GEN create_gen (int run, int size, double* in, double* out, int rate, int mode)
 {
 	GEN a = (GEN) malloc0 (sizeof (gen));
@@ -159,8 +224,9 @@ GEN create_gen (int run, int size, double* in, double* out, int rate, int mode)
 	a->tt.f1 = +  900.0;
 	a->tt.f2 = + 1700.0;
 	// noise
-	srand ((unsigned int)time (0));
 	a->noise.mag = 1.0;
+	a->noise.seed = 0;
+	seed_noise (a);
 	// sweep
 	a->sweep.mag = 1.0;
 	a->sweep.f1 = -20000.0;
@@ -200,6 +266,8 @@ void destroy_gen (GEN a)
 
 void flush_gen (GEN a)
 {
+	if (a->noise.seed)
+		seed_noise (a);
 	a->pulse.state = 0;
 	a->ttpulse.state = 0;
 }
@@ -221,77 +289,37 @@ void xgen (GEN a)
 		case 0:	// tone
 			{
 				int i;
-				double t1, t2;
-				double cosphase = cos (a->tone.phs);
-				double sinphase = sin (a->tone.phs);
-				for (i = 0; i < a->size; i++)
-				{
-					a->out[2 * i + 0] = + a->tone.mag * cosphase;
-					a->out[2 * i + 1] = - a->tone.mag * sinphase;
-					t1 = cosphase;
-					t2 = sinphase;
-					cosphase = t1 * a->tone.cosdelta - t2 * a->tone.sindelta;
-					sinphase = t1 * a->tone.sindelta + t2 * a->tone.cosdelta;
-					a->tone.phs += a->tone.delta;
-					if (a->tone.phs >= TWOPI) a->tone.phs -= TWOPI;
-					if (a->tone.phs <   0.0 ) a->tone.phs += TWOPI;
-				}
+				xnco (&a->tone.osc, a->size, a->out);
+				for (i = 0; i < 2 * a->size; i++)
+					a->out[i] *= a->tone.mag;
 				break;
 			}
 		case 1:	// two-tone
 			{
-				int i;
-				double tcos, tsin;
-				double cosphs1 = cos (a->tt.phs1);
-				double sinphs1 = sin (a->tt.phs1);
-				double cosphs2 = cos (a->tt.phs2);
-				double sinphs2 = sin (a->tt.phs2);
-				for (i = 0; i < a->size; i++)
+				int i, j, m;
+				double cs[2 * NCO_SPAN];
+				xnco (&a->tt.osc1, a->size, a->out);
+				for (j = 0; j < a->size; j += NCO_SPAN)
 				{
-					a->out[2 * i + 0] = + a->tt.mag1 * cosphs1 + a->tt.mag2 * cosphs2;
-					a->out[2 * i + 1] = - a->tt.mag1 * sinphs1 - a->tt.mag2 * sinphs2;
-					tcos = cosphs1;
-					tsin = sinphs1;
-					cosphs1 = tcos * a->tt.cosdelta1 - tsin * a->tt.sindelta1;
-					sinphs1 = tcos * a->tt.sindelta1 + tsin * a->tt.cosdelta1;
-					a->tt.phs1 += a->tt.delta1;
-					if (a->tt.phs1 >= TWOPI) a->tt.phs1 -= TWOPI;
-					if (a->tt.phs1 <   0.0 ) a->tt.phs1 += TWOPI;
-					tcos = cosphs2;
-					tsin = sinphs2;
-					cosphs2 = tcos * a->tt.cosdelta2 - tsin * a->tt.sindelta2;
-					sinphs2 = tcos * a->tt.sindelta2 + tsin * a->tt.cosdelta2;
-					a->tt.phs2 += a->tt.delta2;
-					if (a->tt.phs2 >= TWOPI) a->tt.phs2 -= TWOPI;
-					if (a->tt.phs2 <   0.0 ) a->tt.phs2 += TWOPI;
+					m = min (NCO_SPAN, a->size - j);
+					xnco (&a->tt.osc2, m, cs);
+					for (i = 0; i < 2 * m; i++)
+						a->out[2 * j + i] = a->tt.mag1 * a->out[2 * j + i] + a->tt.mag2 * cs[i];
 				}
 				break;
 			}
 		case 2: // noise
-			{
-				int i;
-				double r1, r2, c, rad;
-				for (i = 0; i < a->size; i++)
-				{
-					do
-					{
-						r1 = 2.0 * (double)rand() / (double)RAND_MAX - 1.0;
-						r2 = 2.0 * (double)rand() / (double)RAND_MAX - 1.0;
-						c = r1 * r1 + r2 * r2;
-					} while (c >= 1.0);
-					rad = sqrt (-2.0 * log (c) / c);
-					a->out[2 * i + 0] = a->noise.mag * rad * r1;
-					a->out[2 * i + 1] = a->noise.mag * rad * r2;
-				}
-				break;
-			}
+			xnoise (a, a->size, a->out);
+			break;
 		case 3:  // sweep
 			{
 				int i;
+				double c, s;
 				for (i = 0; i < a->size; i++)
 				{
-					a->out[2 * i + 0] = + a->sweep.mag * cos(a->sweep.phs);
-					a->out[2 * i + 1] = - a->sweep.mag * sin(a->sweep.phs);
+					nco_sincos (a->sweep.phs, &c, &s);
+					a->out[2 * i + 0] = + a->sweep.mag * c;
+					a->out[2 * i + 1] = - a->sweep.mag * s;
 					a->sweep.phs += a->sweep.dphs;
 					a->sweep.dphs += a->sweep.d2phs;
 					if (a->sweep.phs >= TWOPI) a->sweep.phs -= TWOPI;
@@ -596,6 +624,15 @@ void SetRXAPreGenNoiseMag (int channel, double mag)
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
+PORT
+void SetRXAPreGenNoiseSeed (int channel, unsigned int seed)
+{
+	EnterCriticalSection (&ch[channel].csDSP);
+	rxa[channel].gen0.p->noise.seed = seed;
+	seed_noise (rxa[channel].gen0.p);
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 PORT
 void SetRXAPreGenSweepMag (int channel, double mag)
 {
@@ -673,6 +710,15 @@ void SetTXAPreGenNoiseMag (int channel, double mag)
 	LeaveCriticalSection (&ch[channel].csDSP);
 }
 
+PORT
+void SetTXAPreGenNoiseSeed (int channel, unsigned int seed)
+{
+	EnterCriticalSection (&ch[channel].csDSP);
+	txa[channel].gen0.p->noise.seed = seed;
+	seed_noise (txa[channel].gen0.p);
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 PORT
 void SetTXAPreGenSweepMag (int channel, double mag)
 {
@@ -39,10 +39,8 @@ typedef struct _gen
 	{
 		double mag;
 		double freq;
-		double phs;
 		double delta;
-		double cosdelta;
-		double sindelta;
+		nco osc;				// runs at -delta:  the output is mag * exp(-j * phase)
 	} tone;
 	struct _tt
 	{
@@ -50,18 +48,16 @@ typedef struct _gen
 		double mag2;
 		double f1;
 		double f2;
-		double phs1;
-		double phs2;
 		double delta1;
 		double delta2;
-		double cosdelta1;
-		double cosdelta2;
-		double sindelta1;
-		double sindelta2;
+		nco osc1;
+		nco osc2;
 	} tt;
 	struct _noise
 	{
 		double mag;
+		unsigned int seed;		// 0 to seed from the clock, otherwise the sequence repeats after each flush
+		uint64_t s[4];			// xoshiro256+ state
 	} noise;
 	struct _sweep
 	{
@@ -399,8 +399,9 @@ void create_iobuffs (int channel)
 		a->r2_size = a->out_size;
 	else
 		a->r2_size = a->r2_insize;
-	a->r1_active_buffsize = DSP_MULT * a->r1_size;
-	a->r2_active_buffsize = DSP_MULT * a->r2_size;
+	a->r1_active_buffsize = (DSP_MULT + 1) * a->r1_size;
+	a->r2_active_buffsize = (DSP_MULT + 1) * a->r2_size;
+	a->r1_capacity = a->r1_active_buffsize - a->r1_outsize;
 	a->r1_baseptr = (double*) malloc0 (a->r1_active_buffsize * sizeof (complex));
 	a->r2_baseptr = (double*) malloc0 (a->r2_active_buffsize * sizeof (complex));
 	a->r1_inidx = 0;
@@ -415,6 +416,7 @@ void create_iobuffs (int channel)
 	a->Sem_BuffReady = CreateSemaphore(0, 0, 1000, 0);
 	a->Sem_OutReady  = CreateSemaphore(0, n, 1000, 0);
 	a->bfo = ch[channel].bfo;
+	a->bp = ch[channel].bp;
 	create_slews (a);
 
         InterlockedBitTestAndReset(&a->flush_bypass, 0);
@@ -442,17 +444,23 @@ void destroy_iobuffs (int channel)
 
 void flush_iobuffs (int channel)
 {
+	// call holding csDSP and csEXCH, so neither the dsp side nor an fexchange() caller is in the rings.
+	// Ready buffers are discarded before the rings are emptied; one already taken by a dsp thread, or
+	// still in the pooled run queue, finds no input behind it and is skipped by dexchange().
 	int n;
 	IOB a = ch[channel].iob.pf;
+	while (!WaitForSingleObject (a->Sem_BuffReady, 1));
+	drain_main (channel);
+	PROF_QUEUE (channel, 0);
 	memset (a->r1_baseptr, 0, a->r1_active_buffsize * sizeof (complex));
 	memset (a->r2_baseptr, 0, a->r2_active_buffsize * sizeof (complex));
 	a->r1_inidx = 0;
 	a->r1_outidx = 0;
 	a->r1_unqueuedsamps = 0;
+	a->r1_havesamps = 0;
 	a->r2_inidx = (DSP_MULT - 1) * a->r2_size;
 	a->r2_outidx = 0;
 	a->r2_havesamps = (DSP_MULT - 1) * a->r2_size;
-	while (!WaitForSingleObject (a->Sem_BuffReady, 1));
 	n = a->r2_havesamps / a->out_size;
 	a->r2_unqueuedsamps = a->r2_havesamps - n * a->out_size;
 	CloseHandle (a->Sem_OutReady);
@@ -461,56 +469,111 @@ void flush_iobuffs (int channel)
 }
 
 
-PORT	//double, interleaved I/Q
-void fexchange0 (int channel, double* in, double* out, int* error)
+/********************************************************************************************************
+*																										*
+*											 Exchange Code												*
+*																										*
+********************************************************************************************************/
+
+// The dsp thread works in place in the pseudo-rings:  dexchange() hands it the r1 slot of the next input
+// buffer and the r2 slot its output is to be written to, and the output slot is committed at the next
+// dexchange().  Each ring has one r1_size / r2_size slot more than it holds so that the slots in use
+// are never the ones being written by, or read by, the fexchange() caller.
+//
+// An overrun, input arriving while r1 is full of unprocessed samples, adds -1 to *error; an underrun,
+// no processed output being available, adds -2.  Both are counted in 'stats', with the high-water marks
+// of the unprocessed input and of the processed output held in the rings.
+
+static int accept_in (IOB a, int* error)
+{
+	// returns 1 if the input is to be written at r1_inidx
+	if ((int)ReadAcquire (&a->r1_havesamps) + a->in_size > a->r1_capacity)
+	{
+		a->stats.overruns++;
+		*error += -1;
+		if (a->bp) return 0;
+	}
+	return 1;
+}
+
+static void queue_in (IOB a)
 {
+	// input samples have been written at r1_inidx
 	int n;
+	long have = InterlockedExchangeAdd (&a->r1_havesamps, a->in_size) + a->in_size;
+	if (have > a->stats.r1_hwm) a->stats.r1_hwm = have;
+	if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
+	{
+		n = a->r1_unqueuedsamps / a->r1_outsize;
+		ready_main (a->channel, n);
+		PROF_QUEUE (a->channel, n);
+		a->r1_unqueuedsamps -= n * a->r1_outsize;
+	}
+	if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
+		a->r1_inidx = 0;
+}
+
+static int take_out (IOB a)
+{
+	// returns 1 if output samples are available at r2_outidx
 	int doit = 0;
+	EnterCriticalSection (&a->r2_ControlSection);
+	if (a->r2_havesamps >= a->out_size)
+		doit = 1;
+	if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
+	LeaveCriticalSection (&a->r2_ControlSection);
+	if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
+	return a->bfo || doit;
+}
+
+static void done_out (IOB a)
+{
+	if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
+		a->r2_outidx = 0;
+}
+
+static void exchange_out (IOB a, double* out, int* error)
+{
+	// interleaved double output
+	if (take_out (a))
+		if (_InterlockedAnd (&a->slew.downflag, 1))
+		{
+			downslew0 (a, out);
+			if (!_InterlockedAnd (&a->slew.downflag, 1))
+			{
+				InterlockedBitTestAndReset (&ch[a->channel].exchange, 0);
+				ReleaseSemaphore(a->Sem_Flush, 1, 0);
+			}
+		}
+		else
+			memcpy (out, a->r2_baseptr + 2 * a->r2_outidx, a->out_size * sizeof (complex));
+	else
+	{
+		memset (out, 0, a->out_size * sizeof (complex));
+		a->stats.underruns++;
+		*error += -2;
+	}
+	done_out (a);
+}
+
+PORT	//double, interleaved I/Q
+void fexchange0 (int channel, double* in, double* out, int* error)
+{
 	IOB a;
 	*error = 0;
 	if (_InterlockedAnd (&ch[channel].exchange, 1))
 	{
 		EnterCriticalSection (&ch[channel].csEXCH);
 		a = ch[channel].iob.pe;
-		if (_InterlockedAnd (&a->slew.upflag, 1))
-			upslew0 (a, in);
-		else
-			memcpy (a->r1_baseptr + 2 * a->r1_inidx, in, a->in_size * sizeof (complex));
-		// add check with *error += -1; for case when r1 is full and an overwrite occurs
-		if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
+		if (accept_in (a, error))
 		{
-			n = a->r1_unqueuedsamps / a->r1_outsize;
-			ReleaseSemaphore(a->Sem_BuffReady, n, 0);
-			a->r1_unqueuedsamps -= n * a->r1_outsize;
-		}
-		if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
-			a->r1_inidx = 0;
-
-		EnterCriticalSection (&a->r2_ControlSection);
-		if (a->r2_havesamps >= a->out_size)
-			doit = 1;
-		if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
-		LeaveCriticalSection (&a->r2_ControlSection);
-		if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
-		if (a->bfo || doit)
-			if (_InterlockedAnd (&a->slew.downflag, 1))
-			{
-				downslew0 (a, out);
-				if (!_InterlockedAnd (&a->slew.downflag, 1))
-				{
-					InterlockedBitTestAndReset (&ch[channel].exchange, 0);
-					ReleaseSemaphore(a->Sem_Flush, 1, 0);
-				}
-			}
+			if (_InterlockedAnd (&a->slew.upflag, 1))
+				upslew0 (a, in);
 			else
-				memcpy (out, a->r2_baseptr + 2 * a->r2_outidx, a->out_size * sizeof (complex));
-		else
-		{
-			memset (out, 0, a->out_size * sizeof (complex));
-			*error += -2;
+				memcpy (a->r1_baseptr + 2 * a->r1_inidx, in, a->in_size * sizeof (complex));
+			queue_in (a);
 		}
-		if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
-			a->r2_outidx = 0;
+		exchange_out (a, out, error);
 		LeaveCriticalSection (&ch[channel].csEXCH);
 	}
 }
@@ -518,39 +581,26 @@ void fexchange0 (int channel, double* in, double* out, int* error)
 PORT	//separate I/Q buffers
 void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *Qout, int* error)
 {
-	int i, n;
-	int doit = 0;
+	int i;
 	IOB a;
 	*error = 0;
 	if (_InterlockedAnd (&ch[channel].exchange, 1))
 	{
 		EnterCriticalSection (&ch[channel].csEXCH);
 		a = ch[channel].iob.pe;
-		if (_InterlockedAnd (&a->slew.upflag, 1))
-			upslew2 (a, Iin, Qin);
-		else
-			for (i = 0; i < a->in_size; i++)
-			{
-				(a->r1_baseptr + 2 * a->r1_inidx)[2 * i + 0] = (double)(Iin[i]);
-				(a->r1_baseptr + 2 * a->r1_inidx)[2 * i + 1] = (double)(Qin[i]);
-			}
-																										// add check with *error += -1; for case when r1 is full and an overwrite occurs
-		if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
+		if (accept_in (a, error))
 		{
-			n = a->r1_unqueuedsamps / a->r1_outsize;
-			ReleaseSemaphore(a->Sem_BuffReady, n, 0);	
-			a->r1_unqueuedsamps -= n * a->r1_outsize;
+			if (_InterlockedAnd (&a->slew.upflag, 1))
+				upslew2 (a, Iin, Qin);
+			else
+				for (i = 0; i < a->in_size; i++)
+				{
+					(a->r1_baseptr + 2 * a->r1_inidx)[2 * i + 0] = (double)(Iin[i]);
+					(a->r1_baseptr + 2 * a->r1_inidx)[2 * i + 1] = (double)(Qin[i]);
+				}
+			queue_in (a);
 		}
-		if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
-			a->r1_inidx = 0;
-
-		EnterCriticalSection (&a->r2_ControlSection);
-		if (a->r2_havesamps >= a->out_size)
-			doit = 1;
-		if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
-		LeaveCriticalSection (&a->r2_ControlSection);
-		if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
-		if (a->bfo || doit)
+		if (take_out (a))
 		{
 			if (_InterlockedAnd (&a->slew.downflag, 1))
 			{
@@ -572,24 +622,89 @@ void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *
 		{
 			memset (Iout, 0, a->out_size * sizeof (OUTREAL));
 			memset (Qout, 0, a->out_size * sizeof (OUTREAL));
+			a->stats.underruns++;
 			*error += -2;
 		}
-		if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
-			a->r2_outidx = 0;
+		done_out (a);
 		LeaveCriticalSection (&ch[channel].csEXCH);
 	}
 }
 
-void dexchange (int channel, double* in, double* out)
+PORT	//16-bit, interleaved I/Q
+void fexchange16 (int channel, short* in, double* out, int* error)
 {
+	// input is scaled to +/-1.0; the up-slew, if active, is applied in place in r1
+	double* pin;
+	IOB a;
+	*error = 0;
+	if (_InterlockedAnd (&ch[channel].exchange, 1))
+	{
+		EnterCriticalSection (&ch[channel].csEXCH);
+		a = ch[channel].iob.pe;
+		if (accept_in (a, error))
+		{
+			pin = a->r1_baseptr + 2 * a->r1_inidx;
+			cvt16 (pin, in, 1.0 / 32768.0, a->in_size);
+			if (_InterlockedAnd (&a->slew.upflag, 1))
+				upslew0 (a, pin);
+			queue_in (a);
+		}
+		exchange_out (a, out, error);
+		LeaveCriticalSection (&ch[channel].csEXCH);
+	}
+}
+
+PORT	//packed 24-bit little-endian, interleaved I/Q
+void fexchange24 (int channel, unsigned char* in, double* out, int* error)
+{
+	// input is scaled to +/-1.0; the up-slew, if active, is applied in place in r1
+	double* pin;
+	IOB a;
+	*error = 0;
+	if (_InterlockedAnd (&ch[channel].exchange, 1))
+	{
+		EnterCriticalSection (&ch[channel].csEXCH);
+		a = ch[channel].iob.pe;
+		if (accept_in (a, error))
+		{
+			pin = a->r1_baseptr + 2 * a->r1_inidx;
+			cvt24 (pin, in, 1.0 / 8388608.0, a->in_size);
+			if (_InterlockedAnd (&a->slew.upflag, 1))
+				upslew0 (a, pin);
+			queue_in (a);
+		}
+		exchange_out (a, out, error);
+		LeaveCriticalSection (&ch[channel].csEXCH);
+	}
+}
+
+int dexchange (int channel, double** in, double** out)
+{
+	// returns 1 with 'in' and 'out' set to the slots for the next dsp buffer, 0 if the channel is closing
+	// or there is no input for a buffer
 	int n;
 	IOB a = ch[channel].iob.pd;
-	if (!_InterlockedAnd (&ch[channel].run, 1)) _endthread();
+	if (!_InterlockedAnd (&ch[channel].run, 1))
+	{
+		if (ch[channel].pooled) return 0;		// workers are shared; the channel is being closed
+		_endthread();
+	}
+	// r1 holds r1_outsize samples for every buffer made ready since the last flush; fewer means this
+	// buffer was made ready before a flush emptied the rings
+	if ((int)ReadAcquire (&a->r1_havesamps) < a->r1_outsize) return 0;
+	PROF_QUEUE (channel, -1);
 
+	// take the input first; a caller released by Sem_OutReady below may deliver more at once
+	*in  = a->r1_baseptr + 2 * a->r1_outidx;
+	if ((a->r1_outidx += a->r1_outsize) == a->r1_active_buffsize)
+		a->r1_outidx = 0;
+	InterlockedExchangeAdd (&a->r1_havesamps, -a->r1_outsize);
+
+	// the previous buffer's output is complete in the slot at r2_inidx
 	EnterCriticalSection (&a->r2_ControlSection);
 	a->r2_havesamps += a->r2_insize;
+	if (a->r2_havesamps > a->stats.r2_hwm) a->stats.r2_hwm = a->r2_havesamps;
 	LeaveCriticalSection (&a->r2_ControlSection);
-	memcpy (a->r2_baseptr + 2 * a->r2_inidx, in, a->r2_insize * sizeof (complex));
 	if ((a->r2_inidx += a->r2_insize) == a->r2_active_buffsize)
 		a->r2_inidx = 0;
 	if (a->bfo && (a->r2_unqueuedsamps += a->r2_insize) >= a->out_size)
@@ -598,7 +713,6 @@ void dexchange (int channel, double* in, double* out)
 		ReleaseSemaphore(a->Sem_OutReady, n, 0);	
 		a->r2_unqueuedsamps -= n * a->out_size;
 	}
-	memcpy (out, a->r1_baseptr + 2 * a->r1_outidx, a->r1_outsize * sizeof (complex));
-	if ((a->r1_outidx += a->r1_outsize) == a->r1_active_buffsize)
-		a->r1_outidx = 0;
+	*out = a->r2_baseptr + 2 * a->r2_inidx;
+	return 1;
 }
@@ -43,6 +43,8 @@ typedef struct _iobf
 	int   r1_inidx;								// in 'double', actual index into the buffer is 2 times this
 	int   r1_outidx;							// in 'double', actual index into the buffer is 2 times this
 	int   r1_unqueuedsamps;						// number of input samples not yet queued/released for execution
+	int   r1_capacity;							// most input samples r1 holds without overwriting unprocessed ones
+	volatile long r1_havesamps;					// number of input samples written and not yet taken for processing
 
 	double* r2_baseptr;							// pointer to output pseudo-ring
 	int   r2_inidx;								// in 'double', actual index into the buffer is 2 times this
@@ -52,6 +54,14 @@ typedef struct _iobf
 	CRITICAL_SECTION r2_ControlSection;
 
 	int bfo;									// block_for_output, wait until output is available before proceeding
+	int bp;										// backpressure, refuse input that would overwrite unprocessed samples
+	struct
+	{
+		volatile long overruns;					// fexchange calls whose input overwrote unprocessed samples, or was refused
+		volatile long underruns;				// fexchange calls that found no processed output
+		volatile long r1_hwm;					// high-water mark of r1_havesamps
+		volatile long r2_hwm;					// high-water mark of r2_havesamps
+	} stats;
 	HANDLE Sem_OutReady;						// count = number of 'out_size' buffers processed and available for output
 	HANDLE Sem_BuffReady;						// count = number of 'dsp_size' buffers queued for processing
 	volatile long exec_bypass;
@@ -92,6 +102,12 @@ void fexchange0 (int channel, double* in, double* out, int* error);
 PORT	// separate I/Q buffers
 extern void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *Qout, int* error);
 
-extern void dexchange (int channel, double* in, double* out);
+PORT	// int16, interleaved I/Q
+extern void fexchange16 (int channel, short* in, double* out, int* error);
+
+PORT	// packed int24 little-endian, interleaved I/Q
+extern void fexchange24 (int channel, unsigned char* in, double* out, int* error);
+
+extern int dexchange (int channel, double** in, double** out);
 
 #endif
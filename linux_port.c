@@ -26,6 +26,7 @@ john.d.melton@googlemail.com
 */
 
 #include <errno.h>
+#include <sched.h>
 
 #include "linux_port.h"
 #include "comm.h"
@@ -38,10 +39,211 @@ john.d.melton@googlemail.com
 
 #if defined(linux) || defined(__APPLE__)
 
+/********************************************************************************************************
+*													*
+*	Worker Pool											*
+*													*
+*	QueueUserWorkItem() hands its jobs to a bounded set of persistent worker threads.		*
+*	Jobs are passed through a lock-free, bounded, multi-producer / multi-consumer ring; each	*
+*	slot carries a sequence number that tells producers and consumers whether it is free or		*
+*	filled.  Idle workers block on a semaphore that is posted once per queued job.			*
+*													*
+********************************************************************************************************/
+
+typedef struct _wpjob
+{
+	volatile unsigned long seq;
+	void *(*function)(void *);
+	void *context;
+} wpjob;
+
+static struct _wpool
+{
+	pthread_mutex_t cs;					// serializes pool start / stop
+	volatile long running;
+	volatile long stopping;				// SetWorkerPool() is tearing the pool down to rebuild it
+	volatile long producers;			// QueueUserWorkItem() calls between their 'running' check and their enqueue
+	int nthreads;						// number of worker threads
+	int affinity;						// 1 to pin worker 'i' to cpu 'i % ncpus'
+	pthread_t thread[WP_MAX_THREADS];
+	sem_t *sem_work;					// count = number of queued jobs
+	volatile unsigned long head;		// next slot to dequeue
+	volatile unsigned long tail;		// next slot to enqueue
+	wpjob job[WP_QUEUE_SIZE];
+} wpool = { .cs = PTHREAD_MUTEX_INITIALIZER };
+
+static int wp_enqueue (void *(*function)(void *), void *context)
+{
+	wpjob *j;
+	unsigned long pos = __atomic_load_n (&wpool.tail, __ATOMIC_RELAXED);
+	long dif;
+	for (;;)
+	{
+		j = &wpool.job[pos & (WP_QUEUE_SIZE - 1)];
+		dif = (long)(__atomic_load_n (&j->seq, __ATOMIC_ACQUIRE) - pos);
+		if (dif == 0)
+		{
+			if (__atomic_compare_exchange_n (&wpool.tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		}
+		else if (dif < 0)
+			return 0;		// full
+		else
+			pos = __atomic_load_n (&wpool.tail, __ATOMIC_RELAXED);
+	}
+	j->function = function;
+	j->context = context;
+	__atomic_store_n (&j->seq, pos + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+static int wp_dequeue (wpjob *out)
+{
+	wpjob *j;
+	unsigned long pos = __atomic_load_n (&wpool.head, __ATOMIC_RELAXED);
+	long dif;
+	for (;;)
+	{
+		j = &wpool.job[pos & (WP_QUEUE_SIZE - 1)];
+		dif = (long)(__atomic_load_n (&j->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+		if (dif == 0)
+		{
+			if (__atomic_compare_exchange_n (&wpool.head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		}
+		else if (dif < 0)
+			return 0;		// empty, or the producer that owns this slot has not published it yet
+		else
+			pos = __atomic_load_n (&wpool.head, __ATOMIC_RELAXED);
+	}
+	out->function = j->function;
+	out->context = j->context;
+	__atomic_store_n (&j->seq, pos + WP_QUEUE_SIZE, __ATOMIC_RELEASE);
+	return 1;
+}
+
+static void *wp_worker (void *arg)
+{
+	wpjob j;
+	while (1)
+	{
+		sem_wait (wpool.sem_work);
+		// the semaphore was posted only after a job was published, but an earlier slot may still
+		// be in the hands of a slower producer; wait for it rather than losing the post
+		while (!wp_dequeue (&j))
+			sched_yield ();
+		if (j.function == NULL)
+			break;
+		j.function (j.context);
+	}
+	return NULL;
+}
+
+static void wp_start (void)
+{
+	int i;
+	long ncpus = sysconf (_SC_NPROCESSORS_ONLN);
+	if (ncpus < 1) ncpus = 1;
+	if (wpool.nthreads <= 0)
+		wpool.nthreads = (int)ncpus;
+	if (wpool.nthreads > WP_MAX_THREADS)
+		wpool.nthreads = WP_MAX_THREADS;
+	wpool.head = 0;
+	wpool.tail = 0;
+	for (i = 0; i < WP_QUEUE_SIZE; i++)
+		wpool.job[i].seq = i;
+	wpool.sem_work = LinuxCreateSemaphore (0, 0, 0, 0);
+	for (i = 0; i < wpool.nthreads; i++)
+	{
+		pthread_create (&wpool.thread[i], NULL, wp_worker, NULL);
+#ifndef __APPLE__
+		(void) pthread_setname_np (wpool.thread[i], "WDSP pool");
+		if (wpool.affinity)
+		{
+			cpu_set_t cpus;
+			CPU_ZERO (&cpus);
+			CPU_SET (i % ncpus, &cpus);
+			(void) pthread_setaffinity_np (wpool.thread[i], sizeof (cpu_set_t), &cpus);
+		}
+#endif
+	}
+	__atomic_store_n (&wpool.running, 1, __ATOMIC_RELEASE);
+}
+
+static void wp_stop (void)
+{
+	int i;
+	wpjob j;
+	__atomic_store_n (&wpool.running, 0, __ATOMIC_SEQ_CST);
+	// producers that saw the pool running finish their enqueue before it is torn down;
+	// later ones see it stopped and run their job themselves
+	while (__atomic_load_n (&wpool.producers, __ATOMIC_SEQ_CST))
+		sched_yield ();
+	// one termination job per worker, queued behind any work already submitted
+	for (i = 0; i < wpool.nthreads; i++)
+	{
+		while (!wp_enqueue (NULL, NULL))
+			sched_yield ();
+		sem_post (wpool.sem_work);
+	}
+	for (i = 0; i < wpool.nthreads; i++)
+		pthread_join (wpool.thread[i], NULL);
+	// run anything that slipped in while the workers were shutting down
+	while (wp_dequeue (&j))
+		if (j.function) j.function (j.context);
+	CloseHandle (wpool.sem_work);
+}
+
 void QueueUserWorkItem(void *function,void *context,int flags) {
-	pthread_t t;
-	pthread_create(&t, NULL, function, context);
-	pthread_join(t, NULL);
+	// registering as a producer before checking 'running' pairs with wp_stop(), which clears 'running'
+	// before waiting for the producers to leave.  A producer never blocks on 'cs':  the caller may be a
+	// worker that SetWorkerPool() is waiting to join while holding it.
+	while (__atomic_add_fetch (&wpool.producers, 1, __ATOMIC_SEQ_CST),
+		!__atomic_load_n (&wpool.running, __ATOMIC_SEQ_CST))
+	{
+		__atomic_sub_fetch (&wpool.producers, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n (&wpool.stopping, __ATOMIC_SEQ_CST))
+		{
+			// the pool is being rebuilt:  do the work on the caller's thread
+			((void *(*)(void *))function)(context);
+			return;
+		}
+		if (pthread_mutex_trylock (&wpool.cs) == 0)
+		{
+			// first use:  start the pool
+			if (!wpool.running && !wpool.stopping)
+				wp_start ();
+			pthread_mutex_unlock (&wpool.cs);
+		}
+		else
+			sched_yield ();
+	}
+	if (wp_enqueue ((void *(*)(void *))function, context))
+		sem_post (wpool.sem_work);
+	else
+		// queue is full:  do the work on the caller's thread rather than drop it
+		((void *(*)(void *))function)(context);
+	__atomic_sub_fetch (&wpool.producers, 1, __ATOMIC_RELEASE);
+}
+
+PORT
+void SetWorkerPool (int nthreads, int affinity)
+{
+	// nthreads <= 0 selects one worker per online cpu
+	// may be called while the analyzer is running; jobs submitted while the pool is
+	// being rebuilt run on the thread that submits them
+	pthread_mutex_lock (&wpool.cs);
+	if (wpool.running)
+	{
+		// set before 'running' is cleared, so a producer that sees the pool stopped also sees why
+		__atomic_store_n (&wpool.stopping, 1, __ATOMIC_SEQ_CST);
+		wp_stop ();
+	}
+	wpool.nthreads = nthreads;
+	wpool.affinity = affinity;
+	wp_start ();
+	__atomic_store_n (&wpool.stopping, 0, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock (&wpool.cs);
 }
 
 void InitializeCriticalSectionAndSpinCount(pthread_mutex_t *mutex,int count) {
@@ -76,11 +278,24 @@ int LinuxWaitForSingleObject(sem_t *sem,int ms) {
 		// wait for the lock
 		result=sem_wait(sem);
 	} else {
+#ifdef __APPLE__
         for (int i = 0; i < ms; i++) {
 		result=sem_trywait(sem);
           if (result == 0) break;
           Sleep(1);
 		}
+#else
+		// block until posted or timed out rather than polling every millisecond
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += ms / 1000;
+		ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+		if (ts.tv_nsec >= 1000000000L) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		while ((result=sem_timedwait(sem, &ts)) != 0 && errno == EINTR) ;
+#endif
 	}
 	
 	return result;
@@ -244,6 +459,17 @@ if (sem_destroy((sem_t *)hObject) < 0) {
 return;
 }
 
+//
+// _aligned_malloc() replacement: posix_memalign() honours the requested alignment
+// (malloc0 asks for a cache line) and its memory is released with plain free().
+//
+void *aligned_malloc(size_t size, size_t alignment) {
+  void *p;
+  if (alignment < sizeof(void *)) alignment = sizeof(void *);
+  if (posix_memalign(&p, alignment, size) != 0) return NULL;
+  return p;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //
 // MALLOC debug facility.
@@ -273,7 +499,7 @@ return;
 //
 // P.S.3: The standard definitions in linux_port.h are
 //
-//        __aligned_malloc(a,b) ==>   malloc(a)
+//        __aligned_malloc(a,b) ==>   aligned_malloc(a,b)
 //        __aligned_free(a)     ==>   free(a)
 //
 //        and with these, "MALLOC debug" code is not used.
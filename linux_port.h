@@ -54,19 +54,25 @@ john.d.melton@googlemail.com
 #define InterlockedBitTestAndReset(base,bit) __sync_fetch_and_and(base,~(1L<<bit))
 
 #define InterlockedExchange(target,value) __sync_lock_test_and_set(target,value)
+#define InterlockedExchangeAdd(base,value) __sync_fetch_and_add(base,value)
+#define InterlockedCompareExchange(target,value,comparand) __sync_val_compare_and_swap(target,comparand,value)
 #define InterlockedAnd(base,mask) __sync_fetch_and_and(base,mask)
 #define _InterlockedAnd(base,mask) __sync_fetch_and_and(base,mask)
+#define ReadAcquire(source) __atomic_load_n(source,__ATOMIC_ACQUIRE)
+#define WriteRelease(target,value) __atomic_store_n(target,value,__ATOMIC_RELEASE)
+#define MemoryBarrier() __sync_synchronize()
 #define __declspec(x)
 #define __cdecl
 #define __stdcall
 #define __forceinline
 
-#define _aligned_malloc(x,y) malloc(x)
+#define _aligned_malloc(x,y) aligned_malloc(x,y)
 #define _aligned_free(x)     free(x)
 // Activate these for malloc debug
 //#define _aligned_malloc(x,y) my_malloc(x);
 //#define _aligned_free(x) my_free(x);
 
+void *aligned_malloc(size_t size, size_t alignment);
 void *my_malloc(size_t size);
 void my_free(void *p);
 
@@ -85,8 +91,13 @@ void my_free(void *p);
 
 #define INFINITE -1
 
+#define WP_MAX_THREADS 64					// maximum number of worker pool threads
+#define WP_QUEUE_SIZE 1024					// worker pool job queue size, power of two
+
 void QueueUserWorkItem(void *function,void *context,int flags);
 
+__declspec (dllexport) void SetWorkerPool (int nthreads, int affinity);
+
 void InitializeCriticalSectionAndSpinCount(pthread_mutex_t *mutex,int count);
 
 void EnterCriticalSection(pthread_mutex_t *mutex);
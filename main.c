@@ -26,6 +26,37 @@ warren@wpratt.com
 
 #include "comm.h"
 
+void xmain (int channel)
+{
+	// process one dsp buffer for the channel, in place in the channel's iobuff slots
+	double *in, *out;
+	EnterCriticalSection (&ch[channel].csDSP);
+	if (!_InterlockedAnd (&ch[channel].iob.pd->exec_bypass, 1))
+	{
+		switch (ch[channel].type)
+		{
+		case 0:		// rxa
+			if (dexchange (channel, &in, &out))
+			{
+				setBuffers_rxa (channel, in, out);
+				xrxa (channel);
+			}
+			break;
+		case 1:		// txa
+			if (dexchange (channel, &in, &out))
+			{
+				setBuffers_txa (channel, in, out);
+				xtxa (channel);
+			}
+			break;
+		case 31:	//
+
+			break;
+		}
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 void wdspmain (void *pargs)
 {
 #if defined(_WIN32)
@@ -39,31 +70,192 @@ void wdspmain (void *pargs)
 	while (_InterlockedAnd (&ch[channel].run, 1))
 	{
 		WaitForSingleObject(ch[channel].iob.pd->Sem_BuffReady,INFINITE);
-		EnterCriticalSection (&ch[channel].csDSP);
-		if (!_InterlockedAnd (&ch[channel].iob.pd->exec_bypass, 1))
-		{
-			switch (ch[channel].type)
-			{
-			case 0:		// rxa
-				dexchange (channel, rxa[channel].outbuff, rxa[channel].inbuff);
-				xrxa (channel);
-				break;
-			case 1:		// txa
-				dexchange (channel, txa[channel].outbuff, txa[channel].inbuff);
-				xtxa (channel);
-				break;
-			case 31:	//
-
-				break;
-			}
-		}
-		LeaveCriticalSection (&ch[channel].csDSP);
+		xmain (channel);
 	}
 #if defined(_WIN32)
         if (hTask != 0) AvRevertMmThreadCharacteristics (hTask);
 #endif
 }
 
+/********************************************************************************************************
+*																										*
+*											Pooled Executor												*
+*																										*
+********************************************************************************************************/
+
+// Instead of one thread per channel, a fixed set of worker threads can run the channels.  A channel is
+// in the run queue at most once:  'exec_pending' counts its buffers that are ready but not yet processed,
+// the producer queues the channel on the 0 -> n transition, and the worker that ran a buffer re-queues
+// the channel if more are pending.  Buffers of one channel are therefore processed in order, and by
+// only one worker at a time.
+//
+// The worker count is changed only under 'lock'.  Surplus workers are retired by queueing a stop entry
+// (channel -1) behind the work already queued; the caller waits until they have exited.  While pooled
+// channels are open, at least the workers they were opened with are kept.
+
+#define EXEC_QSIZE			(MAX_CHANNELS + MAX_EXEC_THREADS)
+
+static struct _executor
+{
+	volatile LONG lock;						// serializes changes to the worker count
+	int nthreads;							// workers for channels opened from now on; 0 => one thread per channel
+	int running;							// number of workers started and not told to stop
+	volatile LONG live;						// number of workers that have not yet exited
+	int npooled;							// number of open channels run by the workers
+	int init;
+	CRITICAL_SECTION cs;
+	HANDLE Sem_Work;						// one count per queued channel or stop entry
+	int queue[EXEC_QSIZE];
+	int inidx;
+	int outidx;
+} exec;
+
+static void exec_lock (void)
+{
+	while (InterlockedCompareExchange (&exec.lock, 1, 0) != 0)
+		Sleep (0);
+}
+
+static void exec_unlock (void)
+{
+	InterlockedExchange (&exec.lock, 0);
+}
+
+static void exec_enqueue (int channel)
+{
+	EnterCriticalSection (&exec.cs);
+	exec.queue[exec.inidx] = channel;
+	exec.inidx = (exec.inidx + 1) % EXEC_QSIZE;
+	LeaveCriticalSection (&exec.cs);
+	ReleaseSemaphore (exec.Sem_Work, 1, 0);
+}
+
+void wdspexec (void *pargs)
+{
+#if defined(_WIN32)
+	DWORD taskIndex = 0;
+	HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Pro Audio"), &taskIndex);
+	if (hTask != 0) AvSetMmThreadPriority(hTask, 2);
+	else SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#endif
+	int channel;
+	(void)pargs;
+	while (1)
+	{
+		WaitForSingleObject (exec.Sem_Work, INFINITE);
+		EnterCriticalSection (&exec.cs);
+		channel = exec.queue[exec.outidx];
+		exec.outidx = (exec.outidx + 1) % EXEC_QSIZE;
+		LeaveCriticalSection (&exec.cs);
+		if (channel < 0)
+			break;
+		xmain (channel);
+		if (InterlockedDecrement (&ch[channel].exec_pending) > 0)
+			exec_enqueue (channel);
+	}
+#if defined(_WIN32)
+	if (hTask != 0) AvRevertMmThreadCharacteristics (hTask);
+#endif
+	InterlockedDecrement (&exec.live);
+}
+
+static void resize_exec (void)
+{
+	// call holding 'lock'; starts or retires workers to match 'nthreads' and the open pooled channels
+	int target = exec.nthreads;
+	if (target < exec.running && exec.npooled > 0)
+		target = exec.nthreads > 0 ? exec.nthreads : exec.running;
+	if (!exec.init)
+	{
+		InitializeCriticalSectionAndSpinCount (&exec.cs, 2500);
+		exec.Sem_Work = CreateSemaphore (0, 0, EXEC_QSIZE, 0);
+		exec.init = 1;
+	}
+	while (exec.running < target)
+	{
+		InterlockedIncrement (&exec.live);
+		_beginthread (wdspexec, 0, 0);
+		exec.running++;
+	}
+	while (exec.running > target)
+	{
+		exec_enqueue (-1);
+		exec.running--;
+	}
+	while (ReadAcquire (&exec.live) > exec.running)
+		Sleep (1);
+}
+
+int pooled_main (void)
+{
+	// called when a channel is built; returns 1 if the channel is to be run by the workers
+	int pooled;
+	exec_lock ();
+	if ((pooled = exec.nthreads > 0))
+	{
+		exec.npooled++;
+		resize_exec ();
+	}
+	exec_unlock ();
+	return pooled;
+}
+
+void ready_main (int channel, int n)
+{
+	// 'n' more dsp buffers are ready for the channel
+	if (ch[channel].pooled)
+	{
+		if (InterlockedExchangeAdd (&ch[channel].exec_pending, n) == 0)
+			exec_enqueue (channel);
+	}
+	else
+		ReleaseSemaphore (ch[channel].iob.pe->Sem_BuffReady, n, 0);
+}
+
+void drain_main (int channel)
+{
+	// discard ready buffers that have not yet been processed; call holding csDSP and csEXCH
+	LONG pending;
+	if (!ch[channel].pooled) return;
+	do
+		pending = ch[channel].exec_pending;
+	while (pending > 1 && InterlockedCompareExchange (&ch[channel].exec_pending, 1, pending) != pending);
+}
+
+void stop_main (int channel)
+{
+	// wait until a pooled channel is out of the run queue; call after 'exchange' is off and 'exec_bypass' set
+	while (ch[channel].exec_pending)
+		Sleep (1);
+	exec_lock ();
+	exec.npooled--;
+	resize_exec ();
+	exec_unlock ();
+}
+
+PORT
+void SetDSPExecutor (int nthreads)
+{
+	// nthreads:  0 for one thread per channel; < 0 for one worker per core; applies to channels opened afterwards.
+	// Pooled channels already open keep being run; surplus workers are stopped once they are not needed.
+	if (nthreads < 0)
+	{
+#if defined(_WIN32)
+		SYSTEM_INFO si;
+		GetSystemInfo (&si);
+		nthreads = (int)si.dwNumberOfProcessors;
+#else
+		nthreads = (int)sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+		if (nthreads < 1) nthreads = 1;
+	}
+	if (nthreads > MAX_EXEC_THREADS) nthreads = MAX_EXEC_THREADS;
+	exec_lock ();
+	exec.nthreads = nthreads;
+	if (exec.running > 0) resize_exec ();
+	exec_unlock ();
+}
+
 void create_main (int channel)
 {
 	switch (ch[channel].type)
@@ -27,8 +27,22 @@ warren@wpratt.com
 #ifndef _mainloop_h
 #define _mainloop_h
 
+#define MAX_EXEC_THREADS	MAX_CHANNELS
+
+extern void xmain (int channel);
+
 extern void wdspmain (void *pargs);
 
+extern int pooled_main (void);
+
+extern void ready_main (int channel, int n);
+
+extern void drain_main (int channel);
+
+extern void stop_main (int channel);
+
+extern __declspec (dllexport) void SetDSPExecutor (int nthreads);
+
 extern void create_main (int channel);
 
 extern void destroy_main (int channel);
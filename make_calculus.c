@@ -41,10 +41,10 @@ int main() {
   for (j=0; j<2; j++) {
     switch (j) {
       case 0:
-        printf("double GG[241*241]={\n");
+        printf("const double GG[241*241]={\n");
         break;
       case 1:
-        printf("double GGS[241*241]={\n");
+        printf("const double GGS[241*241]={\n");
         break;
     }
     for (i=0; i< 241*241; i++) {
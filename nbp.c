@@ -241,7 +241,7 @@ void calc_nbp_impulse (NBP a)
 	}
 }
 
-NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, double* in, double* out, 
+NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, int nup, double* in, double* out, 
 	double flow, double fhigh, int rate, int wintype, double gain, int autoincr, int maxpb, NOTCHDB* ptraddr)
 {
 	NBP a = (NBP) malloc0 (sizeof (nbp));
@@ -251,6 +251,7 @@ NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, doub
 	a->size = size;
 	a->nc = nc;
 	a->mp = mp;
+	a->nup = nup;
 	a->rate = (double)rate;
 	a->wintype = wintype;
 	a->gain = gain;
@@ -264,7 +265,7 @@ NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, doub
 	a->bplow   = (double *) malloc0 (a->maxpb * sizeof (double));
 	a->bphigh  = (double *) malloc0 (a->maxpb * sizeof (double));
 	calc_nbp_impulse (a);
-	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, a->impulse);
+	a->p = create_fircore (a->size, a->in, a->out, a->nc, a->mp, a->impulse, a->nup);
 	// print_impulse ("nbp.txt", a->size + 1, impulse, 1, 0);
 	_aligned_free(a->impulse);
 	return a;
@@ -328,6 +329,11 @@ void setMp_nbp (NBP a)
 	setMp_fircore (a->p, a->mp);
 }
 
+void setNup_nbp (NBP a)
+{
+	setNup_fircore (a->p, a->nup);
+}
+
 /********************************************************************************************************
 *																										*
 *											RXA Properties												*
@@ -590,6 +596,20 @@ void RXANBPSetMP (int channel, int mp)
 	}
 }
 
+PORT
+void RXANBPSetNUP (int channel, int nup)
+{
+	NBP a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = rxa[channel].nbp0.p;
+	if (a->nup != nup)
+	{
+		a->nup = nup;
+		setNup_nbp (a);
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
+
 PORT
 void RXANBPGetMinNotchWidth (int channel, double* minwidth)
 {
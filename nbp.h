@@ -53,6 +53,7 @@ typedef struct _nbp
 	int size;				// buffer size
 	int nc;					// number of filter coefficients
 	int mp;					// minimum phase flag
+	int nup;				// non-uniform partition flag
 	double* in;				// input buffer
 	double* out;			// output buffer
 	double flow;			// low bandpass cutoff freq
@@ -72,7 +73,7 @@ typedef struct _nbp
 	int hadnotch;
 } nbp, *NBP;
 
-extern NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, double* in, double* out, 
+extern NBP create_nbp(int run, int fnfrun, int position, int size, int nc, int mp, int nup, double* in, double* out, 
 	double flow, double fhigh, int rate, int wintype, double gain, int autoincr, int maxpb, NOTCHDB* ptraddr);
 
 extern void destroy_nbp (NBP a);
@@ -93,10 +94,14 @@ extern void setNc_nbp (NBP a);
 
 extern void setMp_nbp (NBP a);
 
+extern void setNup_nbp (NBP a);
+
 __declspec (dllexport) void RXANBPSetFreqs (int channel, double flow, double fhigh);
 
 __declspec (dllexport) void RXANBPSetNC (int channel, int nc);
 
 __declspec (dllexport) void RXANBPSetMP (int channel, int mp);
 
+__declspec (dllexport) void RXANBPSetNUP (int channel, int nup);
+
 #endif
@@ -0,0 +1,94 @@
+/*  nco.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include "comm.h"
+
+// Numerically-controlled oscillator shared by the frequency shifter, the signal generators, and the
+// FM modulator.  nco_sincos() looks up the nearest of NCO_TABLE points on the unit circle and rotates
+// it by the residual angle, |r| <= PI / NCO_TABLE, using Taylor series that are exact to double
+// precision over that range.  xnco() makes one such look-up per NCO_SPAN samples and multiplies it by
+// a precomputed run of exp(j * i * delta), so each output sample is independent of the previous one:
+// the loop vectorizes and rounding error does not accumulate along the block.
+
+static double nco_table[2 * NCO_TABLE];		// cos, sin pairs
+static volatile LONG nco_ready;
+
+static void nco_init (void)
+{
+	int i;
+	for (i = 0; i < NCO_TABLE; i++)
+	{
+		nco_table[2 * i + 0] = cos (TWOPI * (double)i / (double)NCO_TABLE);
+		nco_table[2 * i + 1] = sin (TWOPI * (double)i / (double)NCO_TABLE);
+	}
+	WriteRelease (&nco_ready, 1);
+}
+
+void nco_sincos (double phase, double* c, double* s)
+{
+	int k;
+	double r, r2, cr, sr, tc, ts;
+	if (!ReadAcquire (&nco_ready))
+		nco_init ();
+	k = (int)floor (phase * ((double)NCO_TABLE / TWOPI) + 0.5);
+	r = phase - (double)k * (TWOPI / (double)NCO_TABLE);
+	k &= NCO_TABLE - 1;
+	r2 = r * r;
+	cr = 1.0 - r2 * (1.0 / 2.0 - r2 * (1.0 / 24.0 - r2 * (1.0 / 720.0)));
+	sr = r * (1.0 - r2 * (1.0 / 6.0 - r2 * (1.0 / 120.0 - r2 * (1.0 / 5040.0))));
+	tc = nco_table[2 * k + 0];
+	ts = nco_table[2 * k + 1];
+	*c = tc * cr - ts * sr;
+	*s = ts * cr + tc * sr;
+}
+
+double nco_wrap (double phase)
+{
+	if (phase >= TWOPI || phase < 0.0)
+		phase -= TWOPI * floor (phase / TWOPI);
+	return phase;
+}
+
+void set_nco (NCO a, double phase, double delta)
+{
+	int i;
+	a->phase = nco_wrap (phase);
+	a->delta = delta;
+	for (i = 0; i < NCO_SPAN; i++)
+		nco_sincos ((double)i * delta, &a->step[2 * i + 0], &a->step[2 * i + 1]);
+}
+
+void xnco (NCO a, int n, double* osc)
+{
+	int i, j, m;
+	double c, s;
+	double* step = a->step;
+	for (j = 0; j < n; j += NCO_SPAN)
+	{
+		m = min (NCO_SPAN, n - j);
+		nco_sincos (a->phase, &c, &s);
+		for (i = 0; i < m; i++)
+		{
+			osc[2 * (j + i) + 0] = c * step[2 * i + 0] - s * step[2 * i + 1];
+			osc[2 * (j + i) + 1] = s * step[2 * i + 0] + c * step[2 * i + 1];
+		}
+		a->phase = nco_wrap (a->phase + (double)m * a->delta);
+	}
+}
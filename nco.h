@@ -0,0 +1,44 @@
+/*  nco.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef _nco_h
+#define _nco_h
+
+#define NCO_TABLE			512				// table entries per cycle, power of two
+#define NCO_SPAN			64				// samples generated from each table look-up by xnco()
+
+typedef struct _nco
+{
+	double phase;							// phase of the next sample, [0, TWOPI)
+	double delta;							// phase increment per sample
+	double step[2 * NCO_SPAN];				// exp(j * i * delta), i = 0 .. NCO_SPAN - 1
+} nco, *NCO;
+
+// cosine and sine of any phase, from the table and a short series; error is within a few ulp
+extern void nco_sincos (double phase, double* c, double* s);
+
+extern double nco_wrap (double phase);
+
+extern void set_nco (NCO a, double phase, double delta);
+
+// fills 'osc' with 'n' complex samples exp(j * phase), advancing the phase by 'delta' per sample
+extern void xnco (NCO a, int n, double* osc);
+
+#endif
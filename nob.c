@@ -46,6 +46,9 @@ void initBlanker(ANB a)
     a->power = 1.0;
     a->backmult = exp(-1.0 / (a->samplerate * a->backtau));
     a->ombackmult = 1.0 - a->backmult;
+    a->backpow[ANB_SPAN] = 1.0;
+    for (i = ANB_SPAN - 1; i >= 0; i--)
+        a->backpow[i] = a->backpow[i + 1] * a->backmult;
     for (i = 0; i <= a->trans_count; i++)
         a->wave[i] = 0.5 * cos(i * a->coef);
     memset(a->dline, 0, a->dline_size * sizeof(complex));
@@ -104,81 +107,136 @@ void flush_anb (ANB a)
 	LeaveCriticalSection (&a->cs_update);
 }
 
+// Returns 1, with the updated signal average in '*avg', if no sample of the input block can trigger the
+// blanker.  The test is conservative, against the lowest the average could reach in each span, and the
+// average itself is advanced a span at a time as a dot product with powers of 'backmult'.  Nothing in
+// the blanker is changed, so a block that fails can still be run sample by sample from the original
+// state.
+static int anb_quiet (ANB a, double* avg)
+{
+	int i, j, m, hit;
+	double mag[ANB_SPAN];
+	double av = a->avg;
+	double lim;
+	for (j = 0; j < a->buffsize; j += ANB_SPAN)
+	{
+		m = min (ANB_SPAN, a->buffsize - j);
+		cmag (mag, a->in + 2 * j, m);
+		// the average can't fall below av * backmult^m during the span; the margin covers rounding
+		lim = (1.0 - 1.0e-9) * a->threshold * av * a->backpow[ANB_SPAN - m];
+		for (i = 0, hit = 0; i < m; i++)
+			hit |= mag[i] > lim;
+		if (hit)
+			return 0;
+		av = a->backpow[ANB_SPAN - m] * av + a->ombackmult * rdot (a->backpow + ANB_SPAN - m + 1, mag, m);
+	}
+	*avg = av;
+	return 1;
+}
+
+// Idle blanker, quiet block:  the output is the input delayed through the ring, done as block copies.
+// Each copy is written before it is read, so when the write position is behind the read position the
+// copy stops short of the read position to keep the older samples the reads still need.
+static void anb_delay (ANB a)
+{
+	int i, m;
+	for (i = 0; i < a->buffsize; i += m)
+	{
+		m = a->buffsize - i;
+		if (m > a->dline_size - a->in_idx) m = a->dline_size - a->in_idx;
+		if (m > a->dline_size - a->out_idx) m = a->dline_size - a->out_idx;
+		if (a->in_idx < a->out_idx && m > a->out_idx - a->in_idx) m = a->out_idx - a->in_idx;
+		memcpy (a->dline + 2 * a->in_idx, a->in + 2 * i, m * sizeof (complex));
+		memcpy (a->out + 2 * i, a->dline + 2 * a->out_idx, m * sizeof (complex));
+		if ((a->in_idx += m) == a->dline_size) a->in_idx = 0;
+		if ((a->out_idx += m) == a->dline_size) a->out_idx = 0;
+	}
+}
+
 PORT
 void xanb (ANB a)
 {
     double scale;
     double mag;
+	double avg;
 	int i;
     if (a->run)
 	{
 		EnterCriticalSection (&a->cs_update);
-		for (i = 0; i < a->buffsize; i++)
+		if (a->state == 0 && a->count == 0 && anb_quiet (a, &avg))
+		{
+			a->avg = avg;
+			anb_delay (a);
+		}
+		else
 		{
-			mag = sqrt(a->in[2 * i + 0] * a->in[2 * i + 0] + a->in[2 * i + 1] * a->in[2 * i + 1]);
-			a->avg = a->backmult * a->avg + a->ombackmult * mag;
-			a->dline[2 * a->in_idx + 0] = a->in[2 * i + 0];
-			a->dline[2 * a->in_idx + 1] = a->in[2 * i + 1];
-			if (mag > (a->avg * a->threshold))
-				a->count = a->trans_count + a->adv_count;
-
-			switch (a->state)
+			for (i = 0; i < a->buffsize; i++)
 			{
-				case 0:
-					a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0];
-					a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1];
-					if (a->count > 0)
-					{
-						a->state = 1;
-						a->dtime = 0;
-						a->power = 1.0;
-					}
-					break;
-				case 1:
-					scale = a->power * (0.5 + a->wave[a->dtime]);
-					a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0] * scale;
-					a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1] * scale;
-					if (++a->dtime > a->trans_count)
-					{
-						a->state = 2;
-						a->atime = 0;
-					}
-					break;
-				case 2:
-					a->out[2 * i + 0] = 0.0;
-					a->out[2 * i + 1] = 0.0;
-					if (++a->atime > a->adv_count)
-						a->state = 3;
-					break;
-				case 3:
-					if (a->count > 0)
-						a->htime = -a->count;
+				mag = sqrt(a->in[2 * i + 0] * a->in[2 * i + 0] + a->in[2 * i + 1] * a->in[2 * i + 1]);
+				a->avg = a->backmult * a->avg + a->ombackmult * mag;
+				a->dline[2 * a->in_idx + 0] = a->in[2 * i + 0];
+				a->dline[2 * a->in_idx + 1] = a->in[2 * i + 1];
+				if (mag > (a->avg * a->threshold))
+					a->count = a->trans_count + a->adv_count;
+
+				switch (a->state)
+				{
+					case 0:
+						a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0];
+						a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1];
+						if (a->count > 0)
+						{
+							a->state = 1;
+							a->dtime = 0;
+							a->power = 1.0;
+						}
+						break;
+					case 1:
+						scale = a->power * (0.5 + a->wave[a->dtime]);
+						a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0] * scale;
+						a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1] * scale;
+						if (++a->dtime > a->trans_count)
+						{
+							a->state = 2;
+							a->atime = 0;
+						}
+						break;
+					case 2:
+						a->out[2 * i + 0] = 0.0;
+						a->out[2 * i + 1] = 0.0;
+						if (++a->atime > a->adv_count)
+							a->state = 3;
+						break;
+					case 3:
+						if (a->count > 0)
+							a->htime = -a->count;
                                 
-					a->out[2 * i + 0] = 0.0;
-					a->out[2 * i + 1] = 0.0;
-					if (++a->htime > a->hang_count)
-					{
-						a->state = 4;
-						a->itime = 0;
-					}
-					break;
-				case 4:
-					scale = 0.5 - a->wave[a->itime];
-					a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0] * scale;
-					a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1] * scale;
-					if (a->count > 0)
-					{
-						a->state = 1;
-						a->dtime = 0;
-						a->power = scale;
-					}
-					else if (++a->itime > a->trans_count)
-						a->state = 0;
-					break;
+						a->out[2 * i + 0] = 0.0;
+						a->out[2 * i + 1] = 0.0;
+						if (++a->htime > a->hang_count)
+						{
+							a->state = 4;
+							a->itime = 0;
+						}
+						break;
+					case 4:
+						scale = 0.5 - a->wave[a->itime];
+						a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0] * scale;
+						a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1] * scale;
+						if (a->count > 0)
+						{
+							a->state = 1;
+							a->dtime = 0;
+							a->power = scale;
+						}
+						else if (++a->itime > a->trans_count)
+							a->state = 0;
+						break;
+				}
+				if (a->count > 0) a->count--;
+				if (++a->in_idx == a->dline_size) a->in_idx = 0; 
+				if (++a->out_idx == a->dline_size) a->out_idx = 0;
 			}
-			if (a->count > 0) a->count--;
-			if (++a->in_idx == a->dline_size) a->in_idx = 0; 
-			if (++a->out_idx == a->dline_size) a->out_idx = 0;
 		}
 		LeaveCriticalSection (&a->cs_update);
 	}
@@ -27,6 +27,8 @@ warren@wpratt.com
 #ifndef _anb_h
 #define _anb_h
 
+#define ANB_SPAN 256					// samples per pass of the quiet-block check
+
 typedef struct _anb
 {
 	int run;
@@ -58,6 +60,7 @@ typedef struct _anb
     int count;						// set each time a noise sample is detected, counts down
     double backmult;				// multiplier for waveform averaging
     double ombackmult;				// multiplier for waveform averaging
+	double backpow[ANB_SPAN + 1];	// backpow[k] = backmult^(ANB_SPAN - k)
 	CRITICAL_SECTION cs_update;
 	double *legacy;																										////////////  legacy interface - remove
 } anb, *ANB;
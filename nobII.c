@@ -44,6 +44,9 @@ void init_nob (NOB a)
     a->max_imp_seq = (int)(a->max_imp_seq_time * a->samplerate);
     a->backmult = exp (-1.0 / (a->samplerate * a->backtau));
     a->ombackmult = 1.0 - a->backmult;
+    a->backpow[NOB_SPAN] = 1.0;
+    for (i = NOB_SPAN - 1; i >= 0; i--)
+        a->backpow[i] = a->backpow[i + 1] * a->backmult;
     if (a->adv_slew_count > 0)
     {
         coef = PI / (a->adv_slew_count + 1);
@@ -154,6 +157,94 @@ void flush_nob (NOB a)
 	memset (a->ffbuff, 0, a->filterlen * sizeof (complex));
 }
 
+// Returns 1, with the updated signal average in '*avg', if no sample of the input block can be marked
+// as an impulse.  The test is conservative, against the lowest the average could reach in each span,
+// and the average itself is advanced a span at a time as a dot product with powers of 'backmult'.
+// Nothing in the blanker is changed, so a block that fails can still be run sample by sample from the
+// original state.
+static int nob_quiet (NOB a, double* avg)
+{
+	int i, j, m, hit;
+	double mag[NOB_SPAN];
+	double av = a->avg;
+	double lim;
+	for (j = 0; j < a->buffsize; j += NOB_SPAN)
+	{
+		m = min (NOB_SPAN, a->buffsize - j);
+		cmag (mag, a->in + 2 * j, m);
+		// the average can't fall below av * backmult^m during the span; the margin covers rounding
+		lim = (1.0 - 1.0e-9) * a->threshold * av * a->backpow[NOB_SPAN - m];
+		for (i = 0, hit = 0; i < m; i++)
+			hit |= mag[i] > lim;
+		if (hit)
+			return 0;
+		av = a->backpow[NOB_SPAN - m] * av + a->ombackmult * rdot (a->backpow + NOB_SPAN - m + 1, mag, m);
+	}
+	*avg = av;
+	return 1;
+}
+
+// The block leaves state 0 only if one of the positions scanned during it holds an impulse.  Those past
+// the write position's lag are this block's samples, known to be clear; this checks the older ones.
+static int nob_pending (NOB a)
+{
+	int i, idx, n;
+	n = a->in_idx - a->scan_idx;
+	if (n < 0) n += a->dline_size;
+	if (n > a->buffsize) n = a->buffsize;
+	for (i = 0, idx = a->scan_idx; i < n; i++)
+	{
+		if (a->imp[idx]) return 1;
+		if (++idx == a->dline_size) idx = 0;
+	}
+	return 0;
+}
+
+// Idle blanker, quiet block:  the input goes into the ring as block copies with its impulse flags
+// cleared, and the output is the delayed copy.  Each copy is written before it is read, so when the
+// write position is behind the read position the copy stops short of the read position to keep the
+// older samples the reads still need.  The back-filter buffer then takes the same last 'filterlen'
+// clear samples that the per-sample path would have pushed.
+static void nob_delay (NOB a)
+{
+	int i, m, cnt, k, idx;
+	int bf_idx = a->out_idx + a->adv_slew_count;
+	if (bf_idx >= a->dline_size) bf_idx -= a->dline_size;
+	for (i = 0; i < a->buffsize; i += m)
+	{
+		m = a->buffsize - i;
+		if (m > a->dline_size - a->in_idx) m = a->dline_size - a->in_idx;
+		if (m > a->dline_size - a->out_idx) m = a->dline_size - a->out_idx;
+		if (a->in_idx < a->out_idx && m > a->out_idx - a->in_idx) m = a->out_idx - a->in_idx;
+		memcpy (a->dline + 2 * a->in_idx, a->in + 2 * i, m * sizeof (complex));
+		memset (a->imp + a->in_idx, 0, m * sizeof (int));
+		memcpy (a->out + 2 * i, a->dline + 2 * a->out_idx, m * sizeof (complex));
+		if ((a->in_idx += m) == a->dline_size) a->in_idx = 0;
+		if ((a->out_idx += m) == a->dline_size) a->out_idx = 0;
+	}
+	if ((a->scan_idx += a->buffsize) >= a->dline_size) a->scan_idx -= a->dline_size;
+	a->Ilast = a->out[2 * (a->buffsize - 1) + 0];
+	a->Qlast = a->out[2 * (a->buffsize - 1) + 1];
+	for (i = 0, cnt = 0, idx = bf_idx; i < a->buffsize; i++)
+	{
+		cnt += (a->imp[idx] == 0);
+		if (++idx == a->dline_size) idx = 0;
+	}
+	a->bfb_in_idx = (a->bfb_in_idx + cnt) % a->filterlen;
+	if (cnt > a->filterlen) cnt = a->filterlen;
+	for (k = a->bfb_in_idx; cnt > 0; )
+	{
+		if (--idx < 0) idx += a->dline_size;
+		if (a->imp[idx] == 0)
+		{
+			a->bfbuff[2 * k + 0] = a->dline[2 * idx + 0];
+			a->bfbuff[2 * k + 1] = a->dline[2 * idx + 1];
+			if (--k < 0) k += a->filterlen;
+			cnt--;
+		}
+	}
+}
+
 PORT
 void xnob (NOB a)
 {
@@ -169,323 +260,332 @@ void xnob (NOB a)
     int len;
 	int ffcount;
 	int staydown;
+	double avg;
 	EnterCriticalSection (&a->cs_update);
     if (a->run)
 	{
-		for (i = 0; i < a->buffsize; i++)
+		if (a->state == 0 && !nob_pending (a) && nob_quiet (a, &avg))
 		{
-			a->dline[2 * a->in_idx + 0] = a->in[2 * i + 0];
-			a->dline[2 * a->in_idx + 1] = a->in[2 * i + 1];
-			mag = sqrt(a->dline[2 * a->in_idx + 0] * a->dline[2 * a->in_idx + 0] + a->dline[2 * a->in_idx + 1] * a->dline[2 * a->in_idx + 1]);
-			a->avg = a->backmult * a->avg + a->ombackmult * mag;
-			if (mag > (a->avg * a->threshold))
-				a->imp[a->in_idx] = 1;
-			else
-				a->imp[a->in_idx] = 0;
-			if ((bf_idx = a->out_idx + a->adv_slew_count) >= a->dline_size) bf_idx -= a->dline_size;
-			if (a->imp[bf_idx] == 0)
-			{
-				if (++a->bfb_in_idx == a->filterlen) a->bfb_in_idx -= a->filterlen;
-				a->bfbuff[2 * a->bfb_in_idx + 0] = a->dline[2 * bf_idx + 0];
-				a->bfbuff[2 * a->bfb_in_idx + 1] = a->dline[2 * bf_idx + 1];
-			}
-
-			switch (a->state)
+			a->avg = avg;
+			nob_delay (a);
+		}
+		else
+		{
+			for (i = 0; i < a->buffsize; i++)
 			{
-				case 0:     // normal output & impulse setup
-					{
-						a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0];
-						a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1];
-						a->Ilast = a->dline[2 * a->out_idx + 0];
-						a->Qlast = a->dline[2 * a->out_idx + 1];    
-						if (a->imp[a->scan_idx] > 0)
+				a->dline[2 * a->in_idx + 0] = a->in[2 * i + 0];
+				a->dline[2 * a->in_idx + 1] = a->in[2 * i + 1];
+				mag = sqrt(a->dline[2 * a->in_idx + 0] * a->dline[2 * a->in_idx + 0] + a->dline[2 * a->in_idx + 1] * a->dline[2 * a->in_idx + 1]);
+				a->avg = a->backmult * a->avg + a->ombackmult * mag;
+				if (mag > (a->avg * a->threshold))
+					a->imp[a->in_idx] = 1;
+				else
+					a->imp[a->in_idx] = 0;
+				if ((bf_idx = a->out_idx + a->adv_slew_count) >= a->dline_size) bf_idx -= a->dline_size;
+				if (a->imp[bf_idx] == 0)
+				{
+					if (++a->bfb_in_idx == a->filterlen) a->bfb_in_idx -= a->filterlen;
+					a->bfbuff[2 * a->bfb_in_idx + 0] = a->dline[2 * bf_idx + 0];
+					a->bfbuff[2 * a->bfb_in_idx + 1] = a->dline[2 * bf_idx + 1];
+				}
+
+				switch (a->state)
+				{
+					case 0:     // normal output & impulse setup
 						{
-							a->time = 0;
-							if (a->adv_slew_count > 0)
-								a->state = 1;
-							else if (a->adv_count > 0)
-								a->state = 2;
-							else
-								a->state = 3;
-							tidx = a->scan_idx;
-							a->blank_count = 0;
-							do
+							a->out[2 * i + 0] = a->dline[2 * a->out_idx + 0];
+							a->out[2 * i + 1] = a->dline[2 * a->out_idx + 1];
+							a->Ilast = a->dline[2 * a->out_idx + 0];
+							a->Qlast = a->dline[2 * a->out_idx + 1];    
+							if (a->imp[a->scan_idx] > 0)
 							{
-								hcount = 0;
-								while ((a->imp[tidx] > 0 || hcount > 0) && a->blank_count < a->max_imp_seq)
-								{
-									a->blank_count++;
-									if (hcount > 0) hcount--;
-									if (a->imp[tidx] > 0) hcount = a->hang_count + a->hang_slew_count;
-									if (++tidx >= a->dline_size) tidx -= a->dline_size;
-								}
-								j = 1;
-								len = 0;
-								lidx = tidx;
-								while (j <= a->adv_slew_count + a->adv_count && len == 0)
+								a->time = 0;
+								if (a->adv_slew_count > 0)
+									a->state = 1;
+								else if (a->adv_count > 0)
+									a->state = 2;
+								else
+									a->state = 3;
+								tidx = a->scan_idx;
+								a->blank_count = 0;
+								do
 								{
-									if (a->imp[lidx] == 1)
+									hcount = 0;
+									while ((a->imp[tidx] > 0 || hcount > 0) && a->blank_count < a->max_imp_seq)
 									{
-										len = j;
-										tidx = lidx;
+										a->blank_count++;
+										if (hcount > 0) hcount--;
+										if (a->imp[tidx] > 0) hcount = a->hang_count + a->hang_slew_count;
+										if (++tidx >= a->dline_size) tidx -= a->dline_size;
 									}
-									if (++lidx >= a->dline_size) lidx -= a->dline_size;
-									j++;
-								}
-								if((a->blank_count += len) > a->max_imp_seq)
+									j = 1;
+									len = 0;
+									lidx = tidx;
+									while (j <= a->adv_slew_count + a->adv_count && len == 0)
+									{
+										if (a->imp[lidx] == 1)
+										{
+											len = j;
+											tidx = lidx;
+										}
+										if (++lidx >= a->dline_size) lidx -= a->dline_size;
+										j++;
+									}
+									if((a->blank_count += len) > a->max_imp_seq)
+									{
+										a->blank_count = a->max_imp_seq;
+										a->overflow = 1;
+										break;
+									}
+								} while (len != 0);
+								if (a->overflow == 0)
 								{
-									a->blank_count = a->max_imp_seq;
-									a->overflow = 1;
-									break;
-								}
-							} while (len != 0);
-							if (a->overflow == 0)
-							{
-								a->blank_count -= a->hang_slew_count;
-								a->Inext = a->dline[2 * tidx + 0];
-								a->Qnext = a->dline[2 * tidx + 1];
+									a->blank_count -= a->hang_slew_count;
+									a->Inext = a->dline[2 * tidx + 0];
+									a->Qnext = a->dline[2 * tidx + 1];
                                 
-								if (a->mode == 1 || a->mode == 2 || a->mode == 4)
-								{
-									bfboutidx = a->bfb_in_idx;
-									a->I1 = 0.0;
-									a->Q1 = 0.0;
-									for (k = 0; k < a->filterlen; k++)
+									if (a->mode == 1 || a->mode == 2 || a->mode == 4)
 									{
-										a->I1 += a->fcoefs[k] * a->bfbuff[2 * bfboutidx + 0];
-										a->Q1 += a->fcoefs[k] * a->bfbuff[2 * bfboutidx + 1];
-										if (--bfboutidx < 0) bfboutidx += a->filterlen;
+										bfboutidx = a->bfb_in_idx;
+										a->I1 = 0.0;
+										a->Q1 = 0.0;
+										for (k = 0; k < a->filterlen; k++)
+										{
+											a->I1 += a->fcoefs[k] * a->bfbuff[2 * bfboutidx + 0];
+											a->Q1 += a->fcoefs[k] * a->bfbuff[2 * bfboutidx + 1];
+											if (--bfboutidx < 0) bfboutidx += a->filterlen;
+										}
 									}
-								}
 
-								if (a->mode == 2 || a->mode == 3 || a->mode == 4)
-								{
-									if ((ff_idx = a->scan_idx + a->blank_count) >= a->dline_size) ff_idx -= a->dline_size;
-									ffcount = 0;
-									while (ffcount < a->filterlen)
+									if (a->mode == 2 || a->mode == 3 || a->mode == 4)
 									{
-										if (a->imp[ff_idx] == 0)
+										if ((ff_idx = a->scan_idx + a->blank_count) >= a->dline_size) ff_idx -= a->dline_size;
+										ffcount = 0;
+										while (ffcount < a->filterlen)
 										{
-											if (++a->ffb_in_idx == a->filterlen) a->ffb_in_idx -= a->filterlen;
-											a->ffbuff[2 * a->ffb_in_idx + 0] = a->dline[2 * ff_idx + 0];
-											a->ffbuff[2 * a->ffb_in_idx + 1] = a->dline[2 * ff_idx + 1];
-											++ffcount;
+											if (a->imp[ff_idx] == 0)
+											{
+												if (++a->ffb_in_idx == a->filterlen) a->ffb_in_idx -= a->filterlen;
+												a->ffbuff[2 * a->ffb_in_idx + 0] = a->dline[2 * ff_idx + 0];
+												a->ffbuff[2 * a->ffb_in_idx + 1] = a->dline[2 * ff_idx + 1];
+												++ffcount;
+											}
+											if (++ff_idx >= a->dline_size) ff_idx -= a->dline_size;
+										}
+										if ((ffboutidx = a->ffb_in_idx + 1) >= a->filterlen) ffboutidx -= a->filterlen;
+										a->I2 = 0.0;
+										a->Q2 = 0.0;
+										for (k = 0; k < a->filterlen; k++)
+										{
+											a->I2 += a->fcoefs[k] * a->ffbuff[2 * ffboutidx + 0];
+											a->Q2 += a->fcoefs[k] * a->ffbuff[2 * ffboutidx + 1];
+											if (++ffboutidx >= a->filterlen) ffboutidx -= a->filterlen;
 										}
-										if (++ff_idx >= a->dline_size) ff_idx -= a->dline_size;
 									}
-									if ((ffboutidx = a->ffb_in_idx + 1) >= a->filterlen) ffboutidx -= a->filterlen;
-									a->I2 = 0.0;
-									a->Q2 = 0.0;
-									for (k = 0; k < a->filterlen; k++)
+
+									switch (a->mode)
 									{
-										a->I2 += a->fcoefs[k] * a->ffbuff[2 * ffboutidx + 0];
-										a->Q2 += a->fcoefs[k] * a->ffbuff[2 * ffboutidx + 1];
-										if (++ffboutidx >= a->filterlen) ffboutidx -= a->filterlen;
+										case 0: // zero
+											a->deltaI = 0.0;
+											a->deltaQ = 0.0;
+											a->I = 0.0;
+											a->Q = 0.0;
+											break;
+										case 1: // sample-hold
+											a->deltaI = 0.0;
+											a->deltaQ = 0.0;
+											a->I = a->I1;
+											a->Q = a->Q1;
+											break;
+										case 2: // mean-hold
+											a->deltaI = 0.0;
+											a->deltaQ = 0.0;
+											a->I = 0.5 * (a->I1 + a->I2);
+											a->Q = 0.5 * (a->Q1 + a->Q2);
+											break;
+										case 3: // hold-sample
+											a->deltaI = 0.0;
+											a->deltaQ = 0.0;
+											a->I = a->I2;
+											a->Q = a->Q2;
+											break;
+										case 4: // linear interpolation
+											a->deltaI = (a->I2 - a->I1) / (a->adv_count + a->blank_count);
+											a->deltaQ = (a->Q2 - a->Q1) / (a->adv_count + a->blank_count);
+											a->I = a->I1;
+											a->Q = a->Q1;
+											break;
 									}
 								}
-
-								switch (a->mode)
+								else
 								{
-									case 0: // zero
-										a->deltaI = 0.0;
-										a->deltaQ = 0.0;
-										a->I = 0.0;
-										a->Q = 0.0;
-										break;
-									case 1: // sample-hold
-										a->deltaI = 0.0;
-										a->deltaQ = 0.0;
-										a->I = a->I1;
-										a->Q = a->Q1;
-										break;
-									case 2: // mean-hold
-										a->deltaI = 0.0;
-										a->deltaQ = 0.0;
-										a->I = 0.5 * (a->I1 + a->I2);
-										a->Q = 0.5 * (a->Q1 + a->Q2);
-										break;
-									case 3: // hold-sample
-										a->deltaI = 0.0;
-										a->deltaQ = 0.0;
-										a->I = a->I2;
-										a->Q = a->Q2;
-										break;
-									case 4: // linear interpolation
-										a->deltaI = (a->I2 - a->I1) / (a->adv_count + a->blank_count);
-										a->deltaQ = (a->Q2 - a->Q1) / (a->adv_count + a->blank_count);
-										a->I = a->I1;
-										a->Q = a->Q1;
-										break;
+									if (a->adv_slew_count > 0)
+										a->state = 5;
+									else
+									{
+										a->state = 6;
+										a->time = 0;
+										a->blank_count += a->adv_count + a->filterlen;
+									}
 								}
 							}
-							else
+							break;
+						}
+					case 1:     // slew output in advance of blanking period
+						{
+							scale = 0.5 + a->awave[a->time];
+							a->out[2 * i + 0] = a->Ilast * scale + (1.0 - scale) * a->I;
+							a->out[2 * i + 1] = a->Qlast * scale + (1.0 - scale) * a->Q;
+							if (++a->time == a->adv_slew_count)
 							{
-								if (a->adv_slew_count > 0)
-									a->state = 5;
+								a->time = 0;
+								if (a->adv_count > 0)
+									a->state = 2;
 								else
+									a->state = 3;
+							}
+							break;
+						}
+					case 2:     // initial advance period
+						{
+							a->out[2 * i + 0] = a->I;
+							a->out[2 * i + 1] = a->Q;
+							a->I += a->deltaI;
+							a->Q += a->deltaQ;
+
+							if (++a->time == a->adv_count)
+							{
+								a->state = 3;
+								a->time = 0;
+							}
+							break;
+						}
+					case 3:     // impulse & hang period
+						{
+							a->out[2 * i + 0] = a->I;
+							a->out[2 * i + 1] = a->Q;
+							a->I += a->deltaI;
+							a->Q += a->deltaQ;
+
+							if (++a->time == a->blank_count)
+							{
+								if (a->hang_slew_count > 0)
 								{
-									a->state = 6;
+									a->state = 4;
 									a->time = 0;
-									a->blank_count += a->adv_count + a->filterlen;
 								}
+								else 
+									a->state = 0;
 							}
+							break;
 						}
-						break;
-					}
-				case 1:     // slew output in advance of blanking period
-					{
-						scale = 0.5 + a->awave[a->time];
-						a->out[2 * i + 0] = a->Ilast * scale + (1.0 - scale) * a->I;
-						a->out[2 * i + 1] = a->Qlast * scale + (1.0 - scale) * a->Q;
-						if (++a->time == a->adv_slew_count)
+					case 4:     // slew output after blanking period
 						{
-							a->time = 0;
-							if (a->adv_count > 0)
-								a->state = 2;
-							else
-								a->state = 3;
+							scale = 0.5 - a->hwave[a->time];
+							a->out[2 * i + 0] = a->Inext * scale + (1.0 - scale) * a->I;
+							a->out[2 * i + 1] = a->Qnext * scale + (1.0 - scale) * a->Q;
+							if (++a->time == a->hang_slew_count)
+								a->state = 0;
+							break;
 						}
-						break;
-					}
-				case 2:     // initial advance period
-					{
-						a->out[2 * i + 0] = a->I;
-						a->out[2 * i + 1] = a->Q;
-						a->I += a->deltaI;
-						a->Q += a->deltaQ;
-
-						if (++a->time == a->adv_count)
+					case 5:
 						{
-							a->state = 3;
-							a->time = 0;
+							scale = 0.5 + a->awave[a->time];
+							a->out[2 * i + 0] = a->Ilast * scale;
+							a->out[2 * i + 1] = a->Qlast * scale;
+							if (++a->time == a->adv_slew_count)
+	                        {
+	                            a->state = 6;
+	                            a->time = 0;
+	                            a->blank_count += a->adv_count + a->filterlen;
+	                        }
+							break;
 						}
-						break;
-					}
-				case 3:     // impulse & hang period
-					{
-						a->out[2 * i + 0] = a->I;
-						a->out[2 * i + 1] = a->Q;
-						a->I += a->deltaI;
-						a->Q += a->deltaQ;
-
-						if (++a->time == a->blank_count)
+					case 6:
 						{
-							if (a->hang_slew_count > 0)
-							{
-								a->state = 4;
-								a->time = 0;
-							}
-							else 
-								a->state = 0;
+							a->out[2 * i + 0] = 0.0;
+							a->out[2 * i + 1] = 0.0;
+							if (++a->time == a->blank_count)
+								a->state = 7;
+							break;
+						}
+					case 7:
+						{
+							a->out[2 * i + 0] = 0.0;
+							a->out[2 * i + 1] = 0.0;
+	                        staydown = 0;
+	                        a->time = 0;
+	                        if ((tidx = a->scan_idx + a->hang_slew_count + a->hang_count) >= a->dline_size) tidx -= a->dline_size;
+	                        while (a->time++ <= a->adv_count + a->adv_slew_count + a->hang_slew_count + a->hang_count)                                                                            //  CHECK EXACT COUNTS!!!!!!!!!!!!!!!!!!!!!!!
+	                        {
+	                            if (a->imp[tidx] == 1) staydown = 1;
+	                            if (--tidx < 0) tidx += a->dline_size;
+	                        }
+	                        if (staydown == 0)
+	                        {
+	                            if (a->hang_count > 0)
+	                            {
+	                                a->state = 8;
+	                                a->time = 0;
+	                            }
+	                            else if (a->hang_slew_count > 0)
+	                            {
+	                                a->state = 9;
+	                                a->time = 0;
+	                                if ((tidx = a->scan_idx + a->hang_slew_count + a->hang_count - a->adv_count - a->adv_slew_count) >= a->dline_size) tidx -= a->dline_size;
+	                                if (tidx < 0) tidx += a->dline_size;
+	                                a->Inext = a->dline[2 * tidx + 0];
+	                                a->Qnext = a->dline[2 * tidx + 1];
+	                            }
+	                            else
+	                            {
+	                                a->state = 0;
+	                                a->overflow = 0;
+	                            }
+	                        }
+							break;
+						}
+					case 8:
+						{
+							a->out[2 * i + 0] = 0.0;
+							a->out[2 * i + 1] = 0.0;
+							if (++a->time == a->hang_count)
+	                        {
+	                            if (a->hang_slew_count > 0)
+	                            {
+	                                a->state = 9;
+	                                a->time = 0;
+	                                if ((tidx = a->scan_idx + a->hang_slew_count - a->adv_count - a->adv_slew_count) >= a->dline_size) tidx -= a->dline_size;
+	                                if (tidx < 0) tidx += a->dline_size;
+	                                a->Inext = a->dline[2 * tidx + 0];
+	                                a->Qnext = a->dline[2 * tidx + 1];
+	                            }
+	                            else
+	                            {
+	                                a->state = 0;
+	                                a->overflow = 0;
+	                            }
+	                        }
+							break;
+						}
+					case 9:
+						{
+							scale = 0.5 - a->hwave[a->time];
+	                        a->out[2 * i + 0] = a->Inext * scale;
+	                        a->out[2 * i + 1] = a->Qnext * scale;
+
+	                        if (++a->time >= a->hang_slew_count)
+	                        {
+	                            a->state = 0;
+	                            a->overflow = 0;
+	                        }
+							break;
 						}
-						break;
-					}
-				case 4:     // slew output after blanking period
-					{
-						scale = 0.5 - a->hwave[a->time];
-						a->out[2 * i + 0] = a->Inext * scale + (1.0 - scale) * a->I;
-						a->out[2 * i + 1] = a->Qnext * scale + (1.0 - scale) * a->Q;
-						if (++a->time == a->hang_slew_count)
-							a->state = 0;
-						break;
-					}
-				case 5:
-					{
-						scale = 0.5 + a->awave[a->time];
-						a->out[2 * i + 0] = a->Ilast * scale;
-						a->out[2 * i + 1] = a->Qlast * scale;
-						if (++a->time == a->adv_slew_count)
-                        {
-                            a->state = 6;
-                            a->time = 0;
-                            a->blank_count += a->adv_count + a->filterlen;
-                        }
-						break;
-					}
-				case 6:
-					{
-						a->out[2 * i + 0] = 0.0;
-						a->out[2 * i + 1] = 0.0;
-						if (++a->time == a->blank_count)
-							a->state = 7;
-						break;
-					}
-				case 7:
-					{
-						a->out[2 * i + 0] = 0.0;
-						a->out[2 * i + 1] = 0.0;
-                        staydown = 0;
-                        a->time = 0;
-                        if ((tidx = a->scan_idx + a->hang_slew_count + a->hang_count) >= a->dline_size) tidx -= a->dline_size;
-                        while (a->time++ <= a->adv_count + a->adv_slew_count + a->hang_slew_count + a->hang_count)                                                                            //  CHECK EXACT COUNTS!!!!!!!!!!!!!!!!!!!!!!!
-                        {
-                            if (a->imp[tidx] == 1) staydown = 1;
-                            if (--tidx < 0) tidx += a->dline_size;
-                        }
-                        if (staydown == 0)
-                        {
-                            if (a->hang_count > 0)
-                            {
-                                a->state = 8;
-                                a->time = 0;
-                            }
-                            else if (a->hang_slew_count > 0)
-                            {
-                                a->state = 9;
-                                a->time = 0;
-                                if ((tidx = a->scan_idx + a->hang_slew_count + a->hang_count - a->adv_count - a->adv_slew_count) >= a->dline_size) tidx -= a->dline_size;
-                                if (tidx < 0) tidx += a->dline_size;
-                                a->Inext = a->dline[2 * tidx + 0];
-                                a->Qnext = a->dline[2 * tidx + 1];
-                            }
-                            else
-                            {
-                                a->state = 0;
-                                a->overflow = 0;
-                            }
-                        }
-						break;
-					}
-				case 8:
-					{
-						a->out[2 * i + 0] = 0.0;
-						a->out[2 * i + 1] = 0.0;
-						if (++a->time == a->hang_count)
-                        {
-                            if (a->hang_slew_count > 0)
-                            {
-                                a->state = 9;
-                                a->time = 0;
-                                if ((tidx = a->scan_idx + a->hang_slew_count - a->adv_count - a->adv_slew_count) >= a->dline_size) tidx -= a->dline_size;
-                                if (tidx < 0) tidx += a->dline_size;
-                                a->Inext = a->dline[2 * tidx + 0];
-                                a->Qnext = a->dline[2 * tidx + 1];
-                            }
-                            else
-                            {
-                                a->state = 0;
-                                a->overflow = 0;
-                            }
-                        }
-						break;
-					}
-				case 9:
-					{
-						scale = 0.5 - a->hwave[a->time];
-                        a->out[2 * i + 0] = a->Inext * scale;
-                        a->out[2 * i + 1] = a->Qnext * scale;
-
-                        if (++a->time >= a->hang_slew_count)
-                        {
-                            a->state = 0;
-                            a->overflow = 0;
-                        }
-						break;
-					}
+				}
+				if (++a->in_idx == a->dline_size) a->in_idx = 0;
+				if (++a->scan_idx == a->dline_size) a->scan_idx = 0;
+				if (++a->out_idx == a->dline_size) a->out_idx = 0;
 			}
-			if (++a->in_idx == a->dline_size) a->in_idx = 0;
-			if (++a->scan_idx == a->dline_size) a->scan_idx = 0;
-			if (++a->out_idx == a->dline_size) a->out_idx = 0;
 		}
 	}
 	else if (a->in != a->out)
@@ -27,6 +27,8 @@ warren@wpratt.com
 #ifndef _nob_h
 #define _nob_h
 
+#define NOB_SPAN 256					// samples per pass of the quiet-block check
+
 typedef struct _nob
 {
 	int run;
@@ -67,6 +69,7 @@ typedef struct _nob
     int out_idx;                    // ring buffer position from which delayed samples are pulled
     double backmult;				// multiplier for waveform averaging
     double ombackmult;				// multiplier for waveform averaging
+	double backpow[NOB_SPAN + 1];	// backpow[k] = backmult^(NOB_SPAN - k)
 	double I1, Q1;
 	double I2, Q2;
 	double I, Q;
@@ -0,0 +1,221 @@
+/*  profile.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include "comm.h"
+
+#ifdef WDSP_PROFILE
+
+typedef struct _pstage
+{
+	char name[PROF_NAMELEN];
+	unsigned int count;
+	double sum;
+	long long min;
+	long long max;
+	unsigned int hist[PROF_BUCKETS];
+} pstage;
+
+static struct _prof
+{
+	volatile LONG reset;				// set by ResetChannelProfile(), cleared by the dsp thread
+	int nstages;
+	int idx;							// stage to be charged by the next mark
+	long long tbegin;					// time at PROF_BEGIN
+	long long tmark;					// time at the last mark
+	pstage stage[PROF_STAGES];
+	volatile LONG depth;				// dsp buffers waiting
+	LONG maxdepth;
+	double depthsum;
+	unsigned int depthcount;
+} prof[MAX_CHANNELS];
+
+static long long prof_now (void)
+{
+	// nanoseconds from an arbitrary origin
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER t;
+	if (freq.QuadPart == 0) QueryPerformanceFrequency (&freq);
+	QueryPerformanceCounter (&t);
+	return (long long)((double)t.QuadPart * 1.0e9 / (double)freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+static int prof_bucket (long long ns)
+{
+	// four buckets per octave; below 4ns, one per nanosecond
+	int e = 0, b;
+	if (ns < 4) return ns < 0 ? 0 : (int)ns;
+	while ((ns >> e) > 1) e++;
+	b = 4 * (e - 1) + (int)((ns >> (e - 2)) & 3);
+	return b < PROF_BUCKETS ? b : PROF_BUCKETS - 1;
+}
+
+static double prof_edge (int b)
+{
+	// lower edge of bucket 'b', in ns
+	if (b < 4) return (double)b;
+	return (double)(4 + b % 4) * (double)(1LL << (b / 4 - 1));
+}
+
+static void prof_charge (struct _prof* a, const char* name, long long ns)
+{
+	pstage* s;
+	if (a->idx >= PROF_STAGES) return;
+	s = &a->stage[a->idx++];
+	if (a->idx > a->nstages)
+	{
+		a->nstages = a->idx;
+		strncpy (s->name, name, PROF_NAMELEN - 1);
+		s->min = ns;
+	}
+	if (ns < s->min) s->min = ns;
+	if (ns > s->max) s->max = ns;
+	s->sum += (double)ns;
+	s->count++;
+	s->hist[prof_bucket (ns)]++;
+}
+
+void prof_begin (int channel)
+{
+	struct _prof* a = &prof[channel];
+	if (_InterlockedAnd (&a->reset, 0))
+	{
+		memset (a->stage, 0, sizeof (a->stage));
+		a->nstages = 0;
+		a->maxdepth = a->depth;
+		a->depthsum = 0.0;
+		a->depthcount = 0;
+	}
+	a->idx = 0;
+	a->tbegin = a->tmark = prof_now ();
+}
+
+void prof_mark (int channel, const char* name)
+{
+	struct _prof* a = &prof[channel];
+	long long t = prof_now ();
+	prof_charge (a, name, t - a->tmark);
+	a->tmark = t;
+}
+
+void prof_end (int channel)
+{
+	struct _prof* a = &prof[channel];
+	prof_charge (a, "total", prof_now () - a->tbegin);
+}
+
+void prof_queue (int channel, int n)
+{
+	// n > 0:  buffers released to the dsp thread; n < 0:  a buffer taken by the dsp thread; n == 0:  flush
+	struct _prof* a = &prof[channel];
+	LONG depth;
+	if (n > 0)
+	{
+		depth = InterlockedExchangeAdd (&a->depth, n) + n;
+		if (depth > a->maxdepth) a->maxdepth = depth;
+	}
+	else if (n < 0)
+	{
+		a->depthsum += (double)a->depth;
+		a->depthcount++;
+		if (InterlockedExchangeAdd (&a->depth, n) + n < 0)
+			InterlockedExchange (&a->depth, 0);
+	}
+	else
+		InterlockedExchange (&a->depth, 0);
+}
+
+#else
+
+void prof_begin (int channel) { }
+
+void prof_mark (int channel, const char* name) { }
+
+void prof_end (int channel) { }
+
+void prof_queue (int channel, int n) { }
+
+#endif
+
+/********************************************************************************************************
+*																										*
+*											Properties													*
+*																										*
+********************************************************************************************************/
+
+PORT
+int GetChannelProfile (int channel, int stage, char* name, double* stats)
+{
+	// returns the number of stages; for a valid 'stage', 'name' receives up to PROF_NAMELEN characters and
+	// stats[0..4] the number of calls and the min, mean, 99th percentile, and max time in nanoseconds
+#ifdef WDSP_PROFILE
+	struct _prof* a = &prof[channel];
+	pstage* s;
+	unsigned int i, n, target;
+	int b;
+	if (stage < 0 || stage >= a->nstages) return a->nstages;
+	s = &a->stage[stage];
+	if (name) memcpy (name, s->name, PROF_NAMELEN);
+	if (stats)
+	{
+		n = s->count;
+		stats[0] = (double)n;
+		stats[1] = (double)s->min;
+		stats[2] = n ? s->sum / (double)n : 0.0;
+		target = n - n / 100;
+		for (b = 0, i = 0; b < PROF_BUCKETS - 1 && (i += s->hist[b]) < target; b++);
+		stats[3] = 0.5 * (prof_edge (b) + prof_edge (b + 1));
+		if (stats[3] > (double)s->max) stats[3] = (double)s->max;
+		stats[4] = (double)s->max;
+	}
+	return a->nstages;
+#else
+	return 0;
+#endif
+}
+
+PORT
+void GetChannelQueueDepth (int channel, int* depth, int* maxdepth, double* avgdepth)
+{
+	// dsp buffers waiting now, the most seen waiting, and the average found waiting by the dsp thread
+#ifdef WDSP_PROFILE
+	struct _prof* a = &prof[channel];
+	*depth = a->depth;
+	*maxdepth = a->maxdepth;
+	*avgdepth = a->depthcount ? a->depthsum / (double)a->depthcount : 0.0;
+#else
+	*depth = *maxdepth = 0;
+	*avgdepth = 0.0;
+#endif
+}
+
+PORT
+void ResetChannelProfile (int channel)
+{
+	// statistics are cleared at the start of the channel's next pass
+#ifdef WDSP_PROFILE
+	InterlockedBitTestAndSet (&prof[channel].reset, 0);
+#endif
+}
@@ -0,0 +1,60 @@
+/*  profile.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef _profile_h
+#define _profile_h
+
+#define PROF_STAGES			48					// maximum number of timed stages per channel
+#define PROF_NAMELEN		16					// maximum stage name length, including the terminator
+#define PROF_BUCKETS		128					// histogram buckets:  four per octave of nanoseconds
+
+// Per-stage timing of the channel pipelines, compiled in only with WDSP_PROFILE.  In 'xrxa' and 'xtxa',
+// PROF_BEGIN starts a pass and each PROF_MARK charges the time since the previous mark to the named
+// stage; PROF_END charges the whole pass to a final stage, "total".  Stages are numbered in the order
+// they are first marked.  PROF_QUEUE tracks the number of dsp buffers waiting in the channel's iobuffs.
+// Without WDSP_PROFILE the macros are empty and GetChannelProfile() reports no stages.
+
+#ifdef WDSP_PROFILE
+#define PROF_BEGIN(channel)			prof_begin (channel)
+#define PROF_MARK(channel, name)	prof_mark (channel, name)
+#define PROF_END(channel)			prof_end (channel)
+#define PROF_QUEUE(channel, n)		prof_queue (channel, n)
+#else
+#define PROF_BEGIN(channel)
+#define PROF_MARK(channel, name)
+#define PROF_END(channel)
+#define PROF_QUEUE(channel, n)
+#endif
+
+extern void prof_begin (int channel);
+
+extern void prof_mark (int channel, const char* name);
+
+extern void prof_end (int channel);
+
+extern void prof_queue (int channel, int n);
+
+extern __declspec (dllexport) int GetChannelProfile (int channel, int stage, char* name, double* stats);
+
+extern __declspec (dllexport) void GetChannelQueueDepth (int channel, int* depth, int* maxdepth, double* avgdepth);
+
+extern __declspec (dllexport) void ResetChannelProfile (int channel);
+
+#endif
@@ -32,16 +32,121 @@ warren@wpratt.com
 *																								*
 ************************************************************************************************/
 
+/********************************************************************************************************
+*																										*
+*											Half-band Decimators										*
+*																										*
+********************************************************************************************************/
+
+// A large decimation is factored into half-band decimators followed by a shorter polyphase filter.  Each
+// half-band stage passes the final passband, [-fp, +fp], and removes what would alias into it, so the
+// cascade keeps the passband and stopband of the single filter.  The length of each stage follows the
+// same rule as the polyphase filter, about 14 / (normalized transition width), and since every other
+// coefficient of a half-band filter is zero, only the even-index ones and the centre are computed.
+
+static void calc_hbdec (hbdec* b, int rate, double fp)
+{
+	int i, n;
+	double* impulse;
+	n = (int)(14.0 / (0.5 - 2.0 * fp / (double)rate));
+	b->ncoef = 4 * (n / 4) + 3;
+	b->cpp = (b->ncoef + 1) / 2;
+	impulse = fir_bandpass (b->ncoef, -0.25, +0.25, 1.0, 1, 0, 1.0);
+	b->h = (double *)malloc0 (b->cpp * sizeof (double));
+	for (i = 0; i < b->cpp; i++)
+		b->h[i] = impulse[2 * i];
+	b->center = impulse[(b->ncoef - 1) / 2];
+	b->ring = (double *)malloc0 (2 * b->cpp * sizeof (complex));
+	b->idx_in = b->cpp - 1;
+	b->dsize = (b->ncoef + 1) / 4;
+	b->dline = (double *)malloc0 (b->dsize * sizeof (complex));
+	b->didx = 0;
+	b->phase = 0;
+	_aligned_free (impulse);
+}
+
+static void decalc_hbdec (hbdec* b)
+{
+	_aligned_free (b->dline);
+	_aligned_free (b->ring);
+	_aligned_free (b->h);
+}
+
+static void flush_hbdec (hbdec* b)
+{
+	memset (b->ring, 0, 2 * b->cpp * sizeof (complex));
+	memset (b->dline, 0, b->dsize * sizeof (complex));
+	b->idx_in = b->cpp - 1;
+	b->didx = 0;
+	b->phase = 0;
+}
+
+static int xhbdec (hbdec* b, double* in, double* out, int size)
+{
+	// decimate by two; 'out' may be the same as 'in'
+	int i, n = 0;
+	double* d;
+	for (i = 0; i < size; i++)
+	{
+		if (b->phase == 0)
+		{
+			d = b->dline + 2 * b->didx;
+			d[0] = in[2 * i + 0];
+			d[1] = in[2 * i + 1];
+			if (++b->didx == b->dsize) b->didx = 0;
+		}
+		else
+		{
+			b->ring[2 * b->idx_in + 0] = b->ring[2 * (b->idx_in + b->cpp) + 0] = in[2 * i + 0];
+			b->ring[2 * b->idx_in + 1] = b->ring[2 * (b->idx_in + b->cpp) + 1] = in[2 * i + 1];
+			cdotr (out + 2 * n, b->h, b->ring + 2 * b->idx_in, b->cpp);
+			d = b->dline + 2 * b->didx;				// oldest sample, (ncoef - 1) / 2 before this one
+			out[2 * n + 0] += b->center * d[0];
+			out[2 * n + 1] += b->center * d[1];
+			n++;
+			if (--b->idx_in < 0) b->idx_in = b->cpp - 1;
+		}
+		b->phase ^= 1;
+	}
+	return n;
+}
+
+static int plan_hbdec (RESAMPLE a, int M, double fp)
+{
+	// returns the input rate of the polyphase filter.  Stages are used only for the default filter
+	// length, and only while the decimation 'M' is even so every buffer still yields a fixed number of
+	// output samples, and the rate after the stage is at least twice the output rate.
+	int rate = a->in_rate;
+	a->nhb = 0;
+	if (a->ncoefin != 0) return rate;
+	// with M even and L odd, halving the rate leaves gcd(rate, out_rate) unchanged
+	while (a->nhb < RESAMPLE_MAX_HB && M % 2 == 0 && rate / 2 >= 2 * a->out_rate && 4.0 * fp < (double)rate)
+	{
+		calc_hbdec (&a->hb[a->nhb++], rate, fp);
+		rate /= 2;
+		M /= 2;
+	}
+	return rate;
+}
+
+/********************************************************************************************************
+*																										*
+*											Polyphase Resampler											*
+*																										*
+********************************************************************************************************/
+
 void calc_resample (RESAMPLE a)
 {
 	int x, y, z;
 	int i, j, k;
 	int min_rate;
+	int rate;
 	double full_rate;
 	double fc_norm_high, fc_norm_low;
 	double* impulse;
 	a->fc = a->fcin;
 	a->ncoef = a->ncoefin;
+	a->nhb = 0;
 	if ((x = a->in_rate)  <= 0) return;
 	if ((y = a->out_rate) <= 0) return;
 	while (y != 0)
@@ -50,12 +155,15 @@ void calc_resample (RESAMPLE a)
 		y = x % y;
 		x = z;
 	}
-	a->L = a->out_rate / x;
-	a->M = a->in_rate / x;
 	if (a->in_rate < a->out_rate) min_rate = a->in_rate;
 	else min_rate = a->out_rate;
 	if (a->fc == 0.0) a->fc = 0.45 * (double)min_rate;
-	full_rate = (double)(a->in_rate * a->L);
+	rate = plan_hbdec (a, a->in_rate / x, max (fabs (a->fc), fabs (a->fc_low)));
+	a->L = a->out_rate / x;
+	a->M = rate / x;
+	if (rate < a->out_rate) min_rate = rate;
+	else min_rate = a->out_rate;
+	full_rate = (double)(rate * a->L);
 	fc_norm_high = a->fc / full_rate;
 	if (a->fc_low < 0.0)
 		fc_norm_low = - fc_norm_high;
@@ -71,14 +179,21 @@ void calc_resample (RESAMPLE a)
 		for (k = 0; k < a->ncoef; k += a->L)
 			a->h[i++] = impulse[j + k];
 	a->ringsize = a->cpp;
-	a->ring = (double *)malloc0(a->ringsize * sizeof(complex));
+	a->ring = (double *)malloc0(2 * a->ringsize * sizeof(complex));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 	_aligned_free(impulse);
+	a->hbsize = a->size;
+	a->hbbuff = (double *)malloc0(a->hbsize * sizeof(complex));
 }
 
 void decalc_resample (RESAMPLE a)
 {
+	int i;
+	for (i = 0; i < a->nhb; i++)
+		decalc_hbdec (&a->hb[i]);
+	a->nhb = 0;
+	_aligned_free(a->hbbuff);
 	_aligned_free(a->ring);
 	_aligned_free(a->h);
 }
@@ -112,9 +227,12 @@ void destroy_resample (RESAMPLE a)
 PORT
 void flush_resample (RESAMPLE a)
 {
-	memset (a->ring, 0, a->ringsize * sizeof (complex));
+	int i;
+	memset (a->ring, 0, 2 * a->ringsize * sizeof (complex));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
+	for (i = 0; i < a->nhb; i++)
+		flush_hbdec (&a->hb[i]);
 }
 
 PORT
@@ -123,40 +241,38 @@ int xresample (RESAMPLE a)
 	int outsamps = 0;
 	if (a->run)
 	{
-		int i, j, n;
-		int idx_out;
-		double I, Q;
+		int i;
 
 		int cpp = a->cpp;
 		int idx_in = a->idx_in;
 		int ringsize = a->ringsize;
+		int phnum = a->phnum;
 		double* h = a->h;
 		double* ring = a->ring;
+		double* in = a->in;
+		int size = a->size;
 
-		for (i = 0; i < a->size; i++)
+		for (i = 0; i < a->nhb; i++)
 		{
-			ring[2 * idx_in + 0] = a->in[2 * i + 0];
-			ring[2 * idx_in + 1] = a->in[2 * i + 1];
-			while (a->phnum < a->L)
+			size = xhbdec (&a->hb[i], in, a->hbbuff, size);
+			in = a->hbbuff;
+		}
+		for (i = 0; i < size; i++)
+		{
+			// each sample is written twice, so the cpp taps from 'idx_in' never wrap
+			ring[2 * idx_in + 0] = ring[2 * (idx_in + ringsize) + 0] = in[2 * i + 0];
+			ring[2 * idx_in + 1] = ring[2 * (idx_in + ringsize) + 1] = in[2 * i + 1];
+			while (phnum < a->L)
 			{
-				I = 0.0;
-				Q = 0.0;
-				n = cpp * a->phnum;
-				for (j = 0; j < cpp; j++)
-				{
-					if ((idx_out = idx_in + j) >= ringsize) idx_out -= ringsize;
-					I += h[n + j] * ring[2 * idx_out + 0];
-					Q += h[n + j] * ring[2 * idx_out + 1];
-				}
-				a->out[2 * outsamps + 0] = I;
-				a->out[2 * outsamps + 1] = Q;
+				cdotr (a->out + 2 * outsamps, h + cpp * phnum, ring + 2 * idx_in, cpp);
 				outsamps++;
-				a->phnum += a->M;
+				phnum += a->M;
 			}
-			a->phnum -= a->L;
-			if (--idx_in < 0) idx_in = a->ringsize - 1;
+			phnum -= a->L;
+			if (--idx_in < 0) idx_in = ringsize - 1;
 		}
 		a->idx_in = idx_in;
+		a->phnum = phnum;
 	}
 	else if (a->in != a->out)
 		memcpy (a->out, a->in, a->size * sizeof (complex));
@@ -172,6 +288,9 @@ void setBuffers_resample(RESAMPLE a, double* in, double* out)
 void setSize_resample(RESAMPLE a, int size)
 {
 	a->size = size;
+	_aligned_free (a->hbbuff);
+	a->hbsize = a->size;
+	a->hbbuff = (double *)malloc0(a->hbsize * sizeof(complex));
 	flush_resample (a);
 }
 
@@ -225,6 +344,12 @@ void xresampleV (double* input, double* output, int numsamps, int* outsamps, voi
 	a->in = input;
 	a->out = output;
 	a->size = numsamps;
+	if (a->size > a->hbsize)
+	{
+		_aligned_free (a->hbbuff);
+		a->hbsize = a->size;
+		a->hbbuff = (double *)malloc0(a->hbsize * sizeof(complex));
+	}
 	*outsamps = xresample(a);
 }
 
@@ -272,14 +397,14 @@ RESAMPLEF create_resampleF ( int run, int size, float* in, float* out, int in_ra
 	a->ncoef = (int)(60.0 / fc_norm);
 	a->ncoef = (a->ncoef / a->L + 1) * a->L;
 	a->cpp = a->ncoef / a->L;
-	a->h = (double *) malloc0 (a->ncoef * sizeof (double));
+	a->h = (float *) malloc0 (a->ncoef * sizeof (float));
 	impulse = fir_bandpass (a->ncoef, -fc_norm, +fc_norm, 1.0, 1, 0, (double)a->L);
 	i = 0;
 	for (j = 0; j < a->L; j ++)
 		for (k = 0; k < a->ncoef; k += a->L)
-			a->h[i++] = impulse[j + k];
+			a->h[i++] = (float)impulse[j + k];
 	a->ringsize = a->cpp;
-	a->ring = (double *) malloc0 (a->ringsize * sizeof (double));
+	a->ring = (float *) malloc0 (2 * a->ringsize * sizeof (float));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 	_aligned_free (impulse);
@@ -295,7 +420,7 @@ void destroy_resampleF (RESAMPLEF a)
 
 void flush_resampleF (RESAMPLEF a)
 {
-	memset (a->ring, 0, a->ringsize * sizeof (double));
+	memset (a->ring, 0, 2 * a->ringsize * sizeof (float));
 	a->idx_in = a->ringsize - 1;
 	a->phnum = 0;
 }
@@ -305,31 +430,29 @@ int xresampleF (RESAMPLEF a)
 	int outsamps = 0;
 	if (a->run)
 	{
-		int i, j, n;
-		int idx_out;
-		double I;
+		int i;
+
+		int cpp = a->cpp;
+		int idx_in = a->idx_in;
+		int ringsize = a->ringsize;
+		int phnum = a->phnum;
+		float* h = a->h;
+		float* ring = a->ring;
 
 		for (i = 0; i < a->size; i++)
 		{
-			a->ring[a->idx_in] = (double)a->in[i];
-
-			while (a->phnum < a->L)
+			// mirrored ring, as in xresample()
+			ring[idx_in] = ring[idx_in + ringsize] = a->in[i];
+			while (phnum < a->L)
 			{
-				I = 0.0;
-				n = a->cpp * a->phnum;
-				for (j = 0; j < a->cpp; j++)
-				{
-					if ((idx_out = a->idx_in + j) >= a->ringsize) idx_out -= a->ringsize;
-					I += a->h[n + j] * a->ring[idx_out];
-				}
-				a->out[outsamps] = (float)I;
-
-				outsamps++;
-				a->phnum += a->M;
+				a->out[outsamps++] = rdotf (h + cpp * phnum, ring + idx_in, cpp);
+				phnum += a->M;
 			}
-			a->phnum -= a->L;
-			if (--a->idx_in < 0) a->idx_in = a->ringsize - 1;
+			phnum -= a->L;
+			if (--idx_in < 0) idx_in = ringsize - 1;
 		}
+		a->idx_in = idx_in;
+		a->phnum = phnum;
 	}
 	else if (a->in != a->out)
 		memcpy (a->out, a->in, a->size * sizeof (float));
@@ -33,6 +33,22 @@ warren@wpratt.com
 #ifndef _resample_h
 #define _resample_h
 
+#define RESAMPLE_MAX_HB		8		// maximum number of half-band decimators ahead of the polyphase filter
+
+typedef struct _hbdec
+{
+	int ncoef;			// half-band filter length, 4 * k + 3
+	int cpp;			// number of even-index coefficients, (ncoef + 1) / 2
+	double* h;			// even-index coefficients; the odd-index ones are zero except the centre
+	double center;		// centre coefficient
+	int idx_in;			// index for input into ring
+	double* ring;		// mirrored ring, 2 * cpp, of the samples in phase with the outputs
+	int dsize;			// delay line length, k + 1
+	int didx;			// index for input into dline
+	double* dline;		// delay line of the other samples, for the centre coefficient
+	int phase;			// 1 when the next sample completes an output
+} hbdec;
+
 typedef struct _resample
 {
 	int run;			// run
@@ -52,9 +68,13 @@ typedef struct _resample
 	int M;				// decimation factor
 	double* h;			// coefficients
 	int ringsize;		// number of complex pairs the ring buffer holds
-	double* ring;		// ring buffer
+	double* ring;		// mirrored ring buffer, 2 * ringsize; the taps of a phase are contiguous
 	int cpp;			// coefficients of the phase
 	int phnum;			// phase number
+	int nhb;			// number of half-band decimators ahead of the polyphase filter
+	hbdec hb[RESAMPLE_MAX_HB];
+	int hbsize;			// number of complex samples hbbuff holds
+	double* hbbuff;		// output of the half-band decimators
 } resample, *RESAMPLE;
 
 __declspec (dllexport)
@@ -102,9 +122,9 @@ typedef struct _resampleF
 	int ncoef;			// number of coefficients
 	int L;				// interpolation factor
 	int M;				// decimation factor
-	double* h;			// coefficients
+	float* h;			// coefficients
 	int ringsize;		// number of values the ring buffer holds
-	double* ring;		// ring buffer
+	float* ring;		// mirrored ring buffer, 2 * ringsize; the taps of a phase are contiguous
 	int cpp;			// coefficients of the phase
 	int phnum;			// phase number
 } resampleF, *RESAMPLEF;
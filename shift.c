@@ -29,8 +29,7 @@ warren@wpratt.com
 void calc_shift (SHIFT a)
 {
 	a->delta = TWOPI * a->shift / a->rate;
-	a->cos_delta = cos (a->delta);
-	a->sin_delta = sin (a->delta);
+	set_nco (&a->osc, a->osc.phase, a->delta);
 }
 
 SHIFT create_shift (int run, int size, double* in, double* out, int rate, double fshift)
@@ -42,7 +41,7 @@ SHIFT create_shift (int run, int size, double* in, double* out, int rate, double
 	a->out = out;
 	a->rate = (double)rate;
 	a->shift = fshift;
-	a->phase = 0.0;
+	a->osc.phase = 0.0;
 	calc_shift (a);
 	return a;
 }
@@ -54,30 +53,20 @@ void destroy_shift (SHIFT a)
 
 void flush_shift (SHIFT a)
 {
-	a->phase = 0.0;
+	a->osc.phase = 0.0;
 }
 
 void xshift (SHIFT a)
 {
 	if (a->run)
 	{
-		int i;
-		double I1, Q1, t1, t2;
-		double cos_phase = cos (a->phase);
-		double sin_phase = sin (a->phase);
-		for (i = 0; i < a->size; i++)
+		int i, m;
+		double cs[2 * NCO_SPAN];
+		for (i = 0; i < a->size; i += NCO_SPAN)
 		{
-			I1 = a->in[2 * i + 0];
-			Q1 = a->in[2 * i + 1];
-			a->out[2 * i + 0] = I1 * cos_phase - Q1 * sin_phase;
-			a->out[2 * i + 1] = I1 * sin_phase + Q1 * cos_phase;
-			t1 = cos_phase;
-			t2 = sin_phase;
-			cos_phase = t1 * a->cos_delta - t2 * a->sin_delta;
-			sin_phase = t1 * a->sin_delta + t2 * a->cos_delta;
-			a->phase += a->delta;
-			if (a->phase >= TWOPI) a->phase -= TWOPI;
-			if (a->phase <   0.0 ) a->phase += TWOPI;
+			m = min (NCO_SPAN, a->size - i);
+			xnco (&a->osc, m, cs);
+			cmul (a->out + 2 * i, a->in + 2 * i, cs, m);
 		}
 	}
 	else if (a->in != a->out)
@@ -93,7 +82,7 @@ void setBuffers_shift(SHIFT a, double* in, double* out)
 void setSamplerate_shift (SHIFT a, int rate)
 {
 	a->rate = rate;
-	a->phase = 0.0;
+	a->osc.phase = 0.0;
 	calc_shift(a);
 }
 
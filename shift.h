@@ -35,10 +35,8 @@ typedef struct _shift
 	double* out;
 	double rate;
 	double shift;
-	double phase;
 	double delta;
-	double cos_delta;
-	double sin_delta;
+	nco osc;
 } shift, *SHIFT;
 
 extern SHIFT create_shift (int run, int size, double* in, double* out, int rate, double fshift);
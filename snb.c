@@ -725,6 +725,7 @@ void calc_bpsnba (BPSNBA a)
 		a->size,					// buffer size
 		a->nc,						// number of filter coefficients
 		a->mp,						// minimum phase flag
+		a->nup,						// non-uniform partition flag
 		a->buff,					// pointer to input buffer
 		a->out,						// pointer to output buffer
 		a->f_low,					// lower filter frequency
@@ -865,3 +866,18 @@ void RXABPSNBASetMP (int channel, int mp)
 		setMp_nbp (a->bpsnba);
 	}
 }
+
+PORT
+void RXABPSNBASetNUP (int channel, int nup)
+{
+	BPSNBA a;
+	EnterCriticalSection (&ch[channel].csDSP);
+	a = rxa[channel].bpsnba.p;
+	if (a->nup != nup)
+	{
+		a->nup = nup;
+		a->bpsnba->nup = a->nup;
+		setNup_nbp (a->bpsnba);
+	}
+	LeaveCriticalSection (&ch[channel].csDSP);
+}
@@ -129,6 +129,7 @@ typedef struct _bpsnba
 		int size;						// buffer size
 		int nc;							// number of filter coefficients
 		int mp;							// minimum phase flag
+		int nup;						// non-uniform partition flag
 		double* in;						// input buffer
 		double* out;					// output buffer
 		int rate;						// sample rate
@@ -173,4 +174,6 @@ __declspec (dllexport) void RXABPSNBASetNC (int channel, int nc);
 
 __declspec (dllexport) void RXABPSNBASetMP (int channel, int mp);
 
+__declspec (dllexport) void RXABPSNBASetNUP (int channel, int nup);
+
 #endif
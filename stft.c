@@ -0,0 +1,239 @@
+/*  stft.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include "comm.h"
+
+// Short-time Fourier analysis / synthesis shared by the spectral processors (EMNR, CFCOMP).  Each
+// frame of 'fsize' real samples is windowed, transformed, scaled bin-by-bin by the mask the owner's
+// callback computes, transformed back, windowed again, and overlap-added at 'incr' sample steps.
+//
+// The input and output accumulators are linear buffers read and written at increasing offsets; the
+// unread tail is moved back to the front only when a write would run past the end, so frames are
+// always contiguous and no per-sample index wraps.  Overlap-add keeps the partial sums of the frames
+// still in progress in a single buffer, which each new frame completes 'incr' samples of and shifts
+// down in the same pass.  All of the per-sample loops are unit-stride and vectorize.
+
+static void calc_stft (STFT a)
+{
+	int lead, oa, init;
+	// The original EMNR / CFCOMP ring buffers started their output index 'init' samples ahead of the
+	// input index, modulo the ring size 'oa'; the first frame completes 'lead' samples into the
+	// output.  The silence emitted ahead of that frame keeps the same end-to-end latency.
+	if (a->fsize > a->bsize)
+	{
+		oa = a->bsize > a->incr ? a->bsize : a->incr;
+		init = (a->fsize - a->bsize - a->incr) % oa;
+	}
+	else
+	{
+		oa = a->bsize;
+		init = a->fsize - a->incr;
+	}
+	lead = (a->fsize - 1) / a->bsize * a->bsize;
+	a->init_delay = lead + ((init - lead) % oa + oa) % oa;
+}
+
+STFT create_stft (int bsize, int fsize, int ovrlp, int prec, double* window,
+	double igain, double sgain, double ogain, STFT_MASK fmask, void* arg)
+{
+	int i;
+	STFT a = (STFT) malloc0 (sizeof (stft));
+	a->bsize = bsize;
+	a->fsize = fsize;
+	a->ovrlp = ovrlp;
+	a->incr = fsize / ovrlp;
+	a->msize = fsize / 2 + 1;
+	a->prec = prec;
+	a->sgain = sgain;
+	a->fmask = fmask;
+	a->arg = arg;
+	a->awin = (double *) malloc0 (a->fsize * sizeof (double));
+	a->swin = (double *) malloc0 (a->fsize * sizeof (double));
+	for (i = 0; i < a->fsize; i++)
+	{
+		a->awin[i] = igain * window[i];
+		a->swin[i] = ogain * window[i];
+	}
+	a->iasize = 2 * a->fsize + a->bsize;
+	a->inaccum  = (double *) malloc0 (a->iasize * sizeof (double));
+	a->fftin    = (double *) malloc0 (a->fsize * sizeof (double));
+	a->spec     = (double *) malloc0 (a->msize * sizeof (complex));
+	a->mask     = (double *) malloc0 (a->msize * sizeof (double));
+	a->fftout   = (double *) malloc0 (a->fsize * sizeof (double));
+	a->olaccum  = (double *) malloc0 (a->fsize * sizeof (double));
+	a->oasize = 4 * (a->bsize + a->incr);
+	a->outaccum = (double *) malloc0 (a->oasize * sizeof (double));
+	if (a->prec == STFT_FLOAT)
+	{
+		a->ffftin  = (float *) malloc0 (a->fsize * sizeof (float));
+		a->fspec   = (float *) malloc0 (a->msize * 2 * sizeof (float));
+		a->ffftout = (float *) malloc0 (a->fsize * sizeof (float));
+		a->Rforf = fftwf_plan_dft_r2c_1d (a->fsize, a->ffftin, (fftwf_complex *)a->fspec, FFTW_ESTIMATE);
+		a->Rrevf = fftwf_plan_dft_c2r_1d (a->fsize, (fftwf_complex *)a->fspec, a->ffftout, FFTW_ESTIMATE);
+	}
+	else
+	{
+		a->Rfor = fftw_plan_dft_r2c_1d (a->fsize, a->fftin, (fftw_complex *)a->spec, FFTW_ESTIMATE);
+		a->Rrev = fftw_plan_dft_c2r_1d (a->fsize, (fftw_complex *)a->spec, a->fftout, FFTW_ESTIMATE);
+	}
+	calc_stft (a);
+	flush_stft (a);
+	return a;
+}
+
+void destroy_stft (STFT a)
+{
+	if (a->prec == STFT_FLOAT)
+	{
+		fftwf_destroy_plan (a->Rrevf);
+		fftwf_destroy_plan (a->Rforf);
+		_aligned_free (a->ffftout);
+		_aligned_free (a->fspec);
+		_aligned_free (a->ffftin);
+	}
+	else
+	{
+		fftw_destroy_plan (a->Rrev);
+		fftw_destroy_plan (a->Rfor);
+	}
+	_aligned_free (a->outaccum);
+	_aligned_free (a->olaccum);
+	_aligned_free (a->fftout);
+	_aligned_free (a->mask);
+	_aligned_free (a->spec);
+	_aligned_free (a->fftin);
+	_aligned_free (a->inaccum);
+	_aligned_free (a->swin);
+	_aligned_free (a->awin);
+	_aligned_free (a);
+}
+
+void flush_stft (STFT a)
+{
+	memset (a->inaccum,  0, a->iasize * sizeof (double));
+	memset (a->olaccum,  0, a->fsize  * sizeof (double));
+	memset (a->outaccum, 0, a->oasize * sizeof (double));
+	a->iainidx  = 0;
+	a->iaoutidx = 0;
+	a->oainidx  = 0;
+	a->oaoutidx = 0;
+	a->delay = a->init_delay;
+}
+
+static void stft_frame (STFT a, double* x, double* y)
+{
+	int i;
+	double g;
+	double* ol = a->olaccum;
+	double* w = a->swin;
+	double* f = a->fftout;
+	int incr = a->incr;
+	int nsum = a->fsize - 2 * incr;
+	int olsize = a->fsize - incr;
+	if (a->prec == STFT_FLOAT)
+	{
+		for (i = 0; i < a->fsize; i++)
+			a->ffftin[i] = (float)(a->awin[i] * x[i]);
+		fftwf_execute (a->Rforf);
+		for (i = 0; i < 2 * a->msize; i++)
+			a->spec[i] = (double)a->fspec[i];
+	}
+	else
+	{
+		for (i = 0; i < a->fsize; i++)
+			a->fftin[i] = a->awin[i] * x[i];
+		fftw_execute (a->Rfor);
+	}
+	(*a->fmask)(a->arg, a->spec, a->mask);
+	for (i = 0; i < a->msize; i++)
+	{
+		g = a->sgain * a->mask[i];
+		a->spec[2 * i + 0] *= g;
+		a->spec[2 * i + 1] *= g;
+	}
+	if (a->prec == STFT_FLOAT)
+	{
+		for (i = 0; i < 2 * a->msize; i++)
+			a->fspec[i] = (float)a->spec[i];
+		fftwf_execute (a->Rrevf);
+		for (i = 0; i < a->fsize; i++)
+			f[i] = (double)a->ffftout[i];
+	}
+	else
+		fftw_execute (a->Rrev);
+	// the first 'incr' samples are complete; the rest of the sums shift down by 'incr'
+	for (i = 0; i < incr; i++)
+		y[i] = ol[i] + w[i] * f[i];
+	for (i = 0; i < nsum; i++)
+		ol[i] = ol[i + incr] + w[i + incr] * f[i + incr];
+	for (i = nsum > 0 ? nsum : 0; i < olsize; i++)
+		ol[i] = w[i + incr] * f[i + incr];
+}
+
+void xstft (STFT a, double* in, double* out)
+{
+	int i, n, z;
+	double* p;
+	if (a->iainidx + a->bsize > a->iasize)
+	{
+		n = a->iainidx - a->iaoutidx;
+		memmove (a->inaccum, a->inaccum + a->iaoutidx, n * sizeof (double));
+		a->iaoutidx = 0;
+		a->iainidx = n;
+	}
+	p = a->inaccum + a->iainidx;
+	for (i = 0; i < a->bsize; i++)
+		p[i] = in[2 * i + 0];
+	a->iainidx += a->bsize;
+	while (a->iainidx - a->iaoutidx >= a->fsize)
+	{
+		if (a->oainidx + a->incr > a->oasize)
+		{
+			n = a->oainidx - a->oaoutidx;
+			memmove (a->outaccum, a->outaccum + a->oaoutidx, n * sizeof (double));
+			a->oaoutidx = 0;
+			a->oainidx = n;
+		}
+		stft_frame (a, a->inaccum + a->iaoutidx, a->outaccum + a->oainidx);
+		a->iaoutidx += a->incr;
+		a->oainidx += a->incr;
+	}
+	z = a->delay < a->bsize ? a->delay : a->bsize;
+	a->delay -= z;
+	n = a->oainidx - a->oaoutidx;
+	if (n > a->bsize - z) n = a->bsize - z;
+	p = a->outaccum + a->oaoutidx;
+	for (i = 0; i < z; i++)
+	{
+		out[2 * i + 0] = 0.0;
+		out[2 * i + 1] = 0.0;
+	}
+	for (i = 0; i < n; i++)
+	{
+		out[2 * (z + i) + 0] = p[i];
+		out[2 * (z + i) + 1] = 0.0;
+	}
+	for (i = z + n; i < a->bsize; i++)
+	{
+		out[2 * i + 0] = 0.0;
+		out[2 * i + 1] = 0.0;
+	}
+	a->oaoutidx += n;
+}
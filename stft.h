@@ -0,0 +1,79 @@
+/*  stft.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef _stft_h
+#define _stft_h
+
+#define STFT_DOUBLE			0				// transforms in double precision
+#define STFT_FLOAT			1				// transforms in single precision; spectra and masks stay double
+
+// Called once per frame with the 'msize' complex bins of the analysis spectrum; fills 'mask' with
+// 'msize' real gains.  The spectrum may be read but must not be modified.
+typedef void (*STFT_MASK)(void* arg, double* spec, double* mask);
+
+typedef struct _stft
+{
+	int bsize;								// samples per call of xstft()
+	int fsize;								// frame (fft) size
+	int ovrlp;								// frames overlapping each output sample
+	int incr;								// frame advance, fsize / ovrlp
+	int msize;								// spectral bins, fsize / 2 + 1
+	int prec;								// STFT_DOUBLE or STFT_FLOAT
+	double* awin;							// analysis window, including the input gain
+	double* swin;							// synthesis window, including the output gain
+	double sgain;							// spectral gain applied with the mask
+	int iasize;
+	double* inaccum;						// input, frames are read from inaccum + iaoutidx
+	int iainidx;
+	int iaoutidx;
+	double* fftin;
+	double* spec;
+	double* mask;
+	double* fftout;
+	float* ffftin;
+	float* fspec;
+	float* ffftout;
+	double* olaccum;						// partial overlap-add sums of the frames in progress
+	int oasize;
+	double* outaccum;						// finished output, read from outaccum + oaoutidx
+	int oainidx;
+	int oaoutidx;
+	int init_delay;
+	int delay;								// samples of silence still to be output
+	fftw_plan Rfor;
+	fftw_plan Rrev;
+	fftwf_plan Rforf;
+	fftwf_plan Rrevf;
+	STFT_MASK fmask;
+	void* arg;
+} stft, *STFT;
+
+extern STFT create_stft (int bsize, int fsize, int ovrlp, int prec, double* window,
+	double igain, double sgain, double ogain, STFT_MASK fmask, void* arg);
+
+extern void destroy_stft (STFT a);
+
+extern void flush_stft (STFT a);
+
+// 'bsize' complex samples in, 'bsize' complex samples out; only the real parts are processed and
+// the imaginary parts of the output are zero.  'in' and 'out' may be the same buffer.
+extern void xstft (STFT a, double* in, double* out);
+
+#endif
@@ -36,7 +36,7 @@ warren@wpratt.com
 PORT
 void *malloc0 (int size)
 {
-	int alignment = 16;
+	int alignment = 64;		// cache line, and the widest SIMD vector used in cmac.c
 	void* p = _aligned_malloc (size, alignment);
 	if (p != 0) memset (p, 0, size);
 	return p;
@@ -48,11 +48,13 @@ void calc_wcpagc (WCPAGC a)
 	a->state = 0;
 	a->ring = (double *)malloc0(RB_SIZE * sizeof(complex));
 	a->abs_ring = (double *)malloc0(RB_SIZE * sizeof(double));
+	a->dq = (int *)malloc0(RB_SIZE * sizeof(int));
 	loadWcpAGC(a);
 }
 
 void decalc_wcpagc (WCPAGC a)
 {
+	_aligned_free(a->dq);
 	_aligned_free(a->abs_ring);
 	_aligned_free(a->ring);
 }
@@ -112,6 +114,50 @@ WCPAGC create_wcpagc (	int run,
 	return a;
 }
 
+/********************************************************************************************************
+*																										*
+*									Look-Ahead Peak Tracking											*
+*																										*
+********************************************************************************************************/
+
+// ring_max is the maximum of abs_ring over the attack window, the samples after out_index up to and
+// including in_index.  The deque holds the ring indices of the window's candidate maxima, oldest at
+// the front, with strictly decreasing values; each sample is pushed and popped at most once.
+
+static void dq_push (WCPAGC a, int k)
+{
+	int back;
+	while (a->dq_count > 0)
+	{
+		back = a->dq_head + a->dq_count - 1;
+		if (back >= a->ring_buffsize)
+			back -= a->ring_buffsize;
+		if (a->abs_ring[a->dq[back]] > a->abs_ring[k])
+			break;
+		a->dq_count--;
+	}
+	back = a->dq_head + a->dq_count;
+	if (back >= a->ring_buffsize)
+		back -= a->ring_buffsize;
+	a->dq[back] = k;
+	a->dq_count++;
+}
+
+static void dq_rebuild (WCPAGC a)
+{
+	int j, k;
+	a->dq_head = 0;
+	a->dq_count = 0;
+	k = a->out_index;
+	for (j = 0; j < a->attack_buffsize; j++)
+	{
+		if (++k >= a->ring_buffsize)
+			k -= a->ring_buffsize;
+		dq_push (a, k);
+	}
+	a->ring_max = a->dq_count ? a->abs_ring[a->dq[a->dq_head]] : 0.0;
+}
+
 void loadWcpAGC (WCPAGC a)
 {
 	double tmp;
@@ -143,6 +189,7 @@ void loadWcpAGC (WCPAGC a)
 	a->onemhang_backmult = 1.0 - a->hang_backmult;
 
 	a->hang_decay_mult = 1.0 - exp(-1.0 / (a->sample_rate * a->tau_hang_decay));
+	dq_rebuild (a);
 }
 
 void destroy_wcpagc (WCPAGC a)
@@ -156,11 +203,12 @@ void flush_wcpagc (WCPAGC a)
 	memset ((void *)a->ring, 0, sizeof(double) * RB_SIZE * 2);
 	a->ring_max = 0.0;
 	memset ((void *)a->abs_ring, 0, sizeof(double)* RB_SIZE);
+	dq_rebuild (a);
 }
 
 void xwcpagc (WCPAGC a)
 {
-	int i, j, k;
+	int i;
 	double mult;
 	if (a->run)
 	{
@@ -194,20 +242,14 @@ void xwcpagc (WCPAGC a)
 			a->fast_backaverage = a->fast_backmult * a->abs_out_sample + a->onemfast_backmult * a->fast_backaverage;
 			a->hang_backaverage = a->hang_backmult * a->abs_out_sample + a->onemhang_backmult * a->hang_backaverage;
 
-			if ((a->abs_out_sample >= a->ring_max) && (a->abs_out_sample > 0.0))
+			if (a->dq_count > 0 && a->dq[a->dq_head] == a->out_index)
 			{
-				a->ring_max = 0.0;
-				k = a->out_index;
-				for (j = 0; j < a->attack_buffsize; j++)
-				{
-					if (++k == a->ring_buffsize)
-						k = 0;
-					if (a->abs_ring[k] > a->ring_max)
-						a->ring_max = a->abs_ring[k];
-				}
+				if (++a->dq_head >= a->ring_buffsize)
+					a->dq_head -= a->ring_buffsize;
+				a->dq_count--;
 			}
-			if (a->abs_ring[a->in_index] > a->ring_max)
-				a->ring_max = a->abs_ring[a->in_index];
+			dq_push (a, a->in_index);
+			a->ring_max = a->abs_ring[a->dq[a->dq_head]];
 
 			if (a->hang_counter > 0)
 				--a->hang_counter;
@@ -336,7 +378,10 @@ void xwcpagc (WCPAGC a)
 			if (a->volts < a->min_volts)
 				a->volts = a->min_volts;
 			a->gain = a->volts * a->inv_out_target;
-			mult = (a->out_target - a->slope_constant * min (0.0, log10(a->inv_max_input * a->volts))) / a->volts;
+			if (a->volts < a->max_input)
+				mult = (a->out_target - a->slope_constant * mlog10 (a->inv_max_input * a->volts)) / a->volts;
+			else
+				mult = a->out_target / a->volts;
 			a->out[2 * i + 0] = a->out_sample[0] * mult;
 			a->out[2 * i + 1] = a->out_sample[1] * mult;
 		}
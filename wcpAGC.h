@@ -68,6 +68,9 @@ typedef struct _wcpagc
 	double* abs_ring;
 	int ring_buffsize;
 	double ring_max;
+	int* dq;								// monotonic deque of abs_ring indices; abs_ring values decrease from the front
+	int dq_head;
+	int dq_count;
 
 	double attack_mult;
 	double decay_mult;
@@ -102,6 +102,7 @@ extern void SetRXAMode (int channel, int mode);
 extern void RXASetPassband (int channel, double f_low, double f_high);
 extern void RXASetNC (int channel, int nc);
 extern void RXASetMP (int channel, int mp);
+extern void RXASetNUP (int channel, int nup);
 
 //
 // Interfaces from TXA.c
@@ -111,6 +112,7 @@ extern void SetTXAMode (int channel, int mode);
 extern void SetTXABandpassFreqs (int channel, double f_low, double f_high);
 extern void TXASetNC (int channel, int nc);
 extern void TXASetMP (int channel, int mp);
+extern void TXASetNUP (int channel, int nup);
 extern void SetTXAFMAFFilter (int channel, double low, double high);
 
 //
@@ -173,6 +175,14 @@ extern void XCreateAnalyzer(	int disp,
 						int m_stitch,
 						char *app_data_path
 						);
+extern void XCreateAnalyzerEx(	int disp,
+						int *success,
+						int m_size,
+						int m_LO,
+						int m_stitch,
+						int precision,
+						char *app_data_path
+						);
 extern void DestroyAnalyzer(int disp);
 extern void GetPixels	(	int disp,
 					int pixout,
@@ -206,6 +216,20 @@ extern void SetDisplayAvBackmult (int disp, int pixout, double mult);
 extern void SetDisplaySampleRate (int disp, int rate);
 extern void SetDisplayNormOneHz (int disp, int pixout, int norm);
 extern double GetDisplayENB (int disp);
+extern void SetDisplayPixelRing (int disp, int pixout, int run);
+extern void SetDisplayPixelCallback (int disp, int pixout,
+					void (*callback)(void *arg, int disp, int pixout, const dOUTREAL *pixels, int num_pixels,
+						unsigned long long seq, double timestamp),
+					void *arg);
+extern const dOUTREAL* AcquirePixels (int disp, int pixout, unsigned long long after_seq, int *num_pixels,
+					unsigned long long *seq, double *timestamp);
+extern void ReleasePixels (int disp, int pixout, const dOUTREAL *pixels);
+extern void GetDisplayPixelRingStats (int disp, int pixout, unsigned long long *seq, int *dropped);
+extern void SetDisplayHistory (int disp, int pixout, int depth, int format, double lo, double hi);
+extern int GetDisplayHistoryRange (int disp, int pixout, unsigned long long *first_seq, unsigned long long *last_seq);
+extern unsigned long long FindDisplayHistoryFrame (int disp, int pixout, double timestamp);
+extern int GetDisplayHistory (int disp, int pixout, unsigned long long from_seq, int max_frames, int stride,
+					dOUTREAL *pix, unsigned long long *seqs, double *timestamps);
 
 //
 // Interfaces from anf.c
@@ -246,10 +270,12 @@ extern void SetRXABandpassFreqs (int channel, double f_low, double f_high);
 extern void SetRXABandpassWindow (int channel, int wintype);
 extern void SetRXABandpassNC (int channel, int nc);
 extern void SetRXABandpassMP (int channel, int mp);
+extern void SetRXABandpassNUP (int channel, int nup);
 extern void SetTXABandpassRun (int channel, int run);
 extern void SetTXABandpassWindow (int channel, int wintype);
 extern void SetTXABandpassNC (int channel, int nc);
 extern void SetTXABandpassMP (int channel, int mp);
+extern void SetTXABandpassNUP (int channel, int nup);
 
 //
 // Interfaces from calcc.c
@@ -305,6 +331,7 @@ extern void GetTXACFCOMPDisplayCompression (int channel, double* comp_values, in
 
 extern void SetTXACFIRRun (int channel, int run);
 extern void SetTXACFIRNC(int channel, int nc);
+extern void SetTXACFIRNUP(int channel, int nup);
 
 //
 // Interfaces from channel.c
@@ -325,6 +352,17 @@ extern void SetChannelTDelayUp (int channel, double time);
 extern void SetChannelTSlewUp (int channel, double time);
 extern void SetChannelTDelayDown (int channel, double time);
 extern void SetChannelTSlewDown (int channel, double time);
+extern void SetChannelBackpressure (int channel, int bp);
+extern int GetChannelInputSpace (int channel);
+extern void GetChannelStats (int channel, int* overruns, int* underruns, int* r1_hwm, int* r2_hwm);
+extern void ResetChannelStats (int channel);
+
+//
+// Interfaces from cmac.c
+//
+
+extern void SetCMACLevel (int level);
+extern int GetCMACLevel (void);
 
 //
 // Interfaces from compress.c
@@ -449,6 +487,7 @@ extern void SetTXAFMEmphPosition (int channel, int position);
 extern void SetRXAEQRun (int channel, int run);
 extern void SetRXAEQNC (int channel, int nc);
 extern void SetRXAEQMP (int channel, int mp);
+extern void SetRXAEQNUP (int channel, int nup);
 extern void SetRXAEQProfile (int channel, int nfreqs, double* F, double* G);
 extern void SetRXAEQCtfmode (int channel, int mode);
 extern void SetRXAEQWintype (int channel, int wintype);
@@ -457,6 +496,7 @@ extern void SetRXAGrphEQ10 (int channel, int *rxeq);
 extern void SetTXAEQRun (int channel, int run);
 extern void SetTXAEQNC (int channel, int nc);
 extern void SetTXAEQMP (int channel, int mp);
+extern void SetTXAEQNUP (int channel, int nup);
 extern void SetTXAEQProfile (int channel, int nfreqs, double* F, double* G);
 extern void SetTXAEQCtfmode (int channel, int mode);
 extern void SetTXAEQWintype (int channel, int wintype);
@@ -489,6 +529,7 @@ extern void SetRXAFMMPaud (int channel, int mp);
 extern void SetRXAFMLimRun (int channel, int run);
 extern void SetRXAFMLimGain (int channel, double gaindB);
 extern void SetRXAFMAFFilter(int channel, double low, double high);
+extern void SetRXAFMDetectorMode (int channel, int mode);
 
 //
 // Interfaces from fmmod.c
@@ -531,6 +572,7 @@ extern void SetRXAPreGenMode (int channel, int mode);
 extern void SetRXAPreGenToneMag (int channel, double mag);
 extern void SetRXAPreGenToneFreq (int channel, double freq);
 extern void SetRXAPreGenNoiseMag (int channel, double mag);
+extern void SetRXAPreGenNoiseSeed (int channel, unsigned int seed);
 extern void SetRXAPreGenSweepMag (int channel, double mag);
 extern void SetRXAPreGenSweepFreq (int channel, double freq1, double freq2);
 extern void SetRXAPreGenSweepRate (int channel, double rate);
@@ -539,6 +581,7 @@ extern void SetTXAPreGenMode (int channel, int mode);
 extern void SetTXAPreGenToneMag (int channel, double mag);
 extern void SetTXAPreGenToneFreq (int channel, double freq);
 extern void SetTXAPreGenNoiseMag (int channel, double mag);
+extern void SetTXAPreGenNoiseSeed (int channel, unsigned int seed);
 extern void SetTXAPreGenSweepMag (int channel, double mag);
 extern void SetTXAPreGenSweepFreq (int channel, double freq1, double freq2);
 extern void SetTXAPreGenSweepRate (int channel, double rate);
@@ -608,6 +651,8 @@ extern void destroy_impulse_cache(void);
 
 extern void fexchange0 (int channel, double* in, double* out, int* error);
 extern void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *Qout, int* error);
+extern void fexchange16 (int channel, short* in, double* out, int* error);
+extern void fexchange24 (int channel, unsigned char* in, double* out, int* error);
 
 //
 // Interfaces from iqc.c
@@ -619,6 +664,18 @@ extern void SetTXAiqcSwap (int channel, double* cm, double* cc, double* cs);
 extern void SetTXAiqcStart (int channel, double* cm, double* cc, double* cs);
 extern void SetTXAiqcEnd (int channel);
 
+//
+// Interfaces from linux_port.c
+//
+
+extern void SetWorkerPool (int nthreads, int affinity);
+
+//
+// Interfaces from main.c
+//
+
+extern void SetDSPExecutor (int nthreads);
+
 //
 // Interfaces from meter.c
 //
@@ -643,6 +700,7 @@ extern void RXANBPSetFreqs (int channel, double flow, double fhigh);
 extern void RXANBPSetWindow (int channel, int wintype);
 extern void RXANBPSetNC (int channel, int nc);
 extern void RXANBPSetMP (int channel, int mp);
+extern void RXANBPSetNUP (int channel, int nup);
 extern void RXANBPGetMinNotchWidth (int channel, double* minwidth);
 extern void RXANBPSetAutoIncrease (int channel, int autoincr);
 
@@ -775,6 +833,14 @@ extern void SetTXAPanelRun (int channel, int run);
 extern void SetTXAPanelGain1 (int channel, double gain);
 extern void SetTXAPanelSelect (int channel, int select);
 
+//
+// Interfaces from profile.c
+//
+
+extern int GetChannelProfile (int channel, int stage, char* name, double* stats);
+extern void GetChannelQueueDepth (int channel, int* depth, int* maxdepth, double* avgdepth);
+extern void ResetChannelProfile (int channel);
+
 //
 // Interfaces from resample.c
 //
@@ -874,6 +940,7 @@ extern  void SetRXASNBApmultmin (int channel, double pmultmin) ;
 extern  void SetRXASNBAOutputBandwidth (int channel, double flow, double fhigh) ;
 extern void RXABPSNBASetNC (int channel, int nc);
 extern void RXABPSNBASetMP (int channel, int mp);
+extern void RXABPSNBASetNUP (int channel, int nup);
 
 //
 // Interfaces from ssql.c
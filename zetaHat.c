@@ -24,14 +24,14 @@ warren@pratt.one
 
 */
 
-int CzetaRows = 60;
-int CzetaCols = 60;
-double CzetaGmin = -29.500000;
-double CzetaGmax = 30.500000;
-double CzetaXimin = -39.500000;
-double CzetaXimax = 20.500000;
+const int CzetaRows = 60;
+const int CzetaCols = 60;
+const double CzetaGmin = -29.500000;
+const double CzetaGmax = 30.500000;
+const double CzetaXimin = -39.500000;
+const double CzetaXimax = 20.500000;
 
-double CzetaHat [3600] =
+const double CzetaHat [3600] =
 {
 -2.03586637202129217e-01,  -3.74513652516225259e-01,  -3.10912072833603337e-01,  -2.02514089829728905e-01,  
 -1.96721540574476245e-01,  -1.83334244549224173e-01,  -3.15591121929669705e-01,  -4.19011239656620849e-01,  
@@ -935,7 +935,7 @@ double CzetaHat [3600] =
 -1.00000000000000005e+300,  -1.00000000000000005e+300,  -1.00000000000000005e+300,  -1.00000000000000005e+300,  
 };
 
-int CzetaValid [3600] =
+const int CzetaValid [3600] =
 {
 0,  0,  0,  0,  
 0,  0,  0,  0,  
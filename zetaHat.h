@@ -27,15 +27,15 @@ warren@pratt.one
 #ifndef _zetaHat_h
 #define _zetaHat_h
 
-extern int CzetaRows;
-extern int CzetaCols;
-extern double CzetaGmin;
-extern double CzetaGmax;
-extern double CzetaXimin;
-extern double CzetaXimax;
+extern const int CzetaRows;
+extern const int CzetaCols;
+extern const double CzetaGmin;
+extern const double CzetaGmax;
+extern const double CzetaXimin;
+extern const double CzetaXimax;
 
-extern double CzetaHat[];
+extern const double CzetaHat[];
 
-extern int CzetaValid[];
+extern const int CzetaValid[];
 
 #endif